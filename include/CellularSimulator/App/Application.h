@@ -1,12 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <thread>
 
 #include "raylib.h"
 #include "CellularSimulator/Core/Simulator.h"
 #include "RenderData.h"
+#include "TripleBuffer.h"
 
 struct Color;
 struct Camera2D;
@@ -37,31 +40,62 @@ public:
     */
     void Run();
 
+    /**
+     * @brief Computes the display color of a cell from its genome.
+     * @param InCell The cell to color.
+     * @return The color of the cell, or white for an invalid handle.
+     */
+    static Color GetCellColor(const Core::Cell& InCell);
+
+    /**
+     * @brief Fills the render data with the visible part of the simulation grid.
+     * @param InSim The simulation to read.
+     * @param View The visible tiles and the number of tiles per pixel.
+     * @param OutState Receives the covered region and its pixels. The pixel buffer is reused between calls.
+     */
+    static void BuildRenderPixels(Core::Simulator& InSim, const ViewRegion& View, SimulationState& OutState);
+
+    /**
+     * @brief Recomputes the pixels covering the given tiles and widens the dirty row range of the render data.
+     * @param InSim The simulation to read.
+     * @param Tiles The positions of the changed tiles, as collected by Simulator::TakeDirtyTiles.
+     * @param InOutState The render data previously filled by BuildRenderPixels. Tiles outside its region are ignored.
+     */
+    static void PatchRenderPixels(Core::Simulator& InSim, const std::vector<Core::TilePosition>& Tiles, SimulationState& InOutState);
+
 private:
     void UpdateLoop();
     void RenderLoop();
 
     void ProcessInput();
     void Draw();
-
-    static Color GetTileColor(const Core::GridTile* Tile);
-    static Color GetCellColor(const Core::Cell* InCell);
+    void UploadWorldTexture();
+    void PublishView();
+    void PublishRenderState(SimulationState& State);
 
     int32_t WindowWidth = 1280;
     int32_t WindowHeight = 720;
     int32_t TileSize = 10;
     Camera2D WorldCamera{};
+    Texture2D WorldTexture{};
 
     std::atomic<bool> bIsPaused = false;
+    std::atomic<bool> bFastForward = false;
+    std::atomic<uint64_t> TicksToRun = 0;
+    uint64_t TicksPerRun = 1000;
+    std::atomic<bool> bProfileDumpRequested = false;
     std::atomic<int32_t> UpdatesPerSecond = 10;
     int32_t FramesPerSecond = 30;
 
     std::unique_ptr<Core::Simulator> Sim;
     
-    SimulationState SimState;  
-    SimulationState RenderState;
-    SimulationState SharedState;
-    std::mutex SharedStateMutex;
+    InspectorData Inspector;
+    TripleBuffer<SimulationState> RenderBuffers;
+    std::vector<uint64_t> RowGenerations;
+    uint64_t LayoutGeneration = 0;
+    TripleBuffer<ViewRegion> ViewBuffers;
+    ViewRegion PublishedView;
+    uint64_t UploadedGeneration = 0;
 
     std::thread UpdateThread;
     std::atomic<bool> bIsRunning;
@@ -1,8 +1,9 @@
 ﻿#pragma once
 
 #include <cstdint>
+#include <string>
 #include <vector>
-#include "raylib.h"
+#include "CellularSimulator/Core/CellSimulatorTypes.h"
 
 namespace CellularSimulator
 {
@@ -10,23 +11,37 @@ namespace App
 {
 
 /**
- * @struct TileRenderData
- * @brief Represents the rendering data for a single tile in the simulation.
+ * @struct ViewRegion
+ * @brief The part of the world visible on screen, published by the render thread.
  */
-struct TileRenderData
+struct ViewRegion
 {
     /**
-     * @brief The x-coordinate of the tile in the grid.
+     * @brief The first visible tile column. May lie outside the world.
      */
-    int32_t X;
+    int32_t MinX = 0;
     /**
-     * @brief The y-coordinate of the tile in the grid.
+     * @brief The first visible tile row. May lie outside the world.
      */
-    int32_t Y;
+    int32_t MinY = 0;
     /**
-     * @brief The color to render the tile.
+     * @brief One past the last visible tile column.
      */
-    Color TileColor;
+    int32_t MaxX = 0;
+    /**
+     * @brief One past the last visible tile row.
+     */
+    int32_t MaxY = 0;
+    /**
+     * @brief The number of tiles along each axis that fall onto a single screen pixel, at least 1.
+     */
+    int32_t Step = 1;
+
+    bool operator==(const ViewRegion& Other) const
+    {
+        return MinX == Other.MinX && MinY == Other.MinY && MaxX == Other.MaxX && MaxY == Other.MaxY && Step == Other.Step;
+    }
+    bool operator!=(const ViewRegion& Other) const { return !(*this == Other); }
 };
 
 /**
@@ -52,23 +67,61 @@ struct InspectorData
 struct SimulationState
 {
     /**
-     * @brief A vector containing the rendering data for all tiles in the simulation.
+     * @brief The first tile column covered by the pixels.
      */
-    std::vector<TileRenderData> Tiles;
+    int32_t OriginX = 0;
     /**
-     * @brief The inspector data, including genome display information.
+     * @brief The first tile row covered by the pixels.
      */
-    InspectorData Inspector;
+    int32_t OriginY = 0;
     /**
-     * @brief Updates the current simulation state from another instance, swapping tile data and copying inspector information.
-     * @param Other The other SimulationState instance to copy data from.
-     * @note This method uses swap for the Tiles vector to efficiently transfer ownership of the data.
+     * @brief The number of tile columns covered by the pixels.
      */
-    void UpdateFromBuffer(SimulationState& Other) noexcept
-    {
-        Tiles.swap(Other.Tiles);
-        Inspector = Other.Inspector;
-    }
+    int32_t RegionWidth = 0;
+    /**
+     * @brief The number of tile rows covered by the pixels.
+     */
+    int32_t RegionHeight = 0;
+    /**
+     * @brief The number of tiles along each axis averaged into one pixel.
+     */
+    int32_t Step = 1;
+    /**
+     * @brief The width of the pixel buffer.
+     */
+    int32_t Width = 0;
+    /**
+     * @brief The height of the pixel buffer.
+     */
+    int32_t Height = 0;
+    /**
+     * @brief The number of ticks simulated when the state was published.
+     */
+    uint64_t Tick = 0;
+    /**
+     * @brief Incremented on every publication, so the renderer can tell whether it missed one.
+     */
+    uint64_t Generation = 0;
+    /**
+     * @brief True if every pixel has to be uploaded, e.g. after the covered region changed.
+     */
+    bool bFullUpload = true;
+    /**
+     * @brief The first pixel row that changed since the previous generation.
+     */
+    int32_t DirtyRowBegin = 0;
+    /**
+     * @brief One past the last pixel row that changed since the previous generation. Equal to DirtyRowBegin if no pixel changed.
+     */
+    int32_t DirtyRowEnd = 0;
+    /**
+     * @brief One RGBA pixel per Step x Step block of the covered tiles in row-major order, ready to be uploaded as the world texture.
+     */
+    std::vector<Core::CellColor> Pixels;
+    /**
+     * @brief The inspector data, including genome display information.
+     */
+    InspectorData Inspector;
 };
 
 }  // namespace App
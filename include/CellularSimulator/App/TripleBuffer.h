@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace CellularSimulator
+{
+namespace App
+{
+
+/**
+ * @class TripleBuffer
+ * @brief Lock-free single-producer single-consumer hand-off of the latest value.
+ *
+ * The writer fills its private buffer and publishes it by swapping it with the shared middle buffer.
+ * The reader takes the middle buffer in exchange for its own one when something new was published.
+ * Neither side ever waits for the other, and the reader always sees the most recent complete value.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    /**
+     * @brief Provides the buffer owned by the writer thread.
+     * @return The buffer to fill before calling Publish.
+     */
+    T& GetWriteBuffer() { return Buffers[WriteIndex]; }
+
+    /**
+     * @brief Publishes the write buffer and takes the previous middle buffer as the next write buffer.
+     * @note The new write buffer holds older data and has to be refilled completely.
+     */
+    void Publish() { WriteIndex = Middle.exchange(WriteIndex | FreshBit, std::memory_order_acq_rel) & IndexMask; }
+
+    /**
+     * @brief Takes the most recently published buffer, if any was published since the last call.
+     * @return True if the read buffer changed, false if it still holds the previous value.
+     */
+    bool Acquire()
+    {
+        if (!(Middle.load(std::memory_order_relaxed) & FreshBit)) return false;
+        ReadIndex = Middle.exchange(ReadIndex, std::memory_order_acq_rel) & IndexMask;
+        return true;
+    }
+
+    /**
+     * @brief Provides the buffer owned by the reader thread.
+     * @return The most recently acquired value.
+     */
+    const T& GetReadBuffer() const { return Buffers[ReadIndex]; }
+
+private:
+    static constexpr uint8_t FreshBit = 0x4;
+    static constexpr uint8_t IndexMask = 0x3;
+
+    std::array<T, 3> Buffers;
+    uint8_t WriteIndex = 0;
+    std::atomic<uint8_t> Middle = 1;
+    uint8_t ReadIndex = 2;
+};
+
+} // namespace App
+} // namespace CellularSimulator
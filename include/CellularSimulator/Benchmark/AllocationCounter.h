@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+
+namespace CellularSimulator
+{
+namespace Benchmark
+{
+
+/**
+ * @brief Gets the number of calls to the global operator new made by the process so far.
+ *
+ * The benchmark executable replaces the global allocation functions to count them,
+ * so the difference between two calls is the number of heap allocations in between.
+ * @return The total number of allocations.
+ */
+uint64_t GetAllocationCount();
+
+} // namespace Benchmark
+} // namespace CellularSimulator
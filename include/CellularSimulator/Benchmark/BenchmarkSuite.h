@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace CellularSimulator
+{
+namespace Benchmark
+{
+
+/**
+ * @struct BenchmarkConfig
+ * @brief Parameters of a benchmark suite run.
+ */
+struct BenchmarkConfig
+{
+    /**
+     * @brief Only benchmarks whose name contains this text are run. Empty runs all of them.
+     */
+    std::string Filter;
+    /**
+     * @brief The number of simulation steps measured by every update benchmark.
+     */
+    uint64_t Ticks = 20;
+    /**
+     * @brief The number of times every other benchmark is repeated.
+     */
+    uint64_t Repetitions = 5;
+};
+
+/**
+ * @struct BenchmarkResult
+ * @brief The measurements of a single benchmark.
+ */
+struct BenchmarkResult
+{
+    /**
+     * @brief The name of the benchmark.
+     */
+    std::string Name;
+    /**
+     * @brief The unit of work the timings are normalized to, e.g. "cell*tick".
+     */
+    std::string Unit;
+    /**
+     * @brief The average time per unit of work in nanoseconds.
+     */
+    double NsPerItem = 0.0;
+    /**
+     * @brief The unit of iteration the allocations are normalized to, e.g. "tick".
+     */
+    std::string Iteration;
+    /**
+     * @brief The average number of heap allocations per iteration.
+     */
+    double AllocationsPerIteration = 0.0;
+};
+
+/**
+ * @class BenchmarkSuite
+ * @brief Measures the hot paths of the simulation core and, when built with it, of the front-end.
+ *
+ * Every benchmark reports the time per unit of work (a cell and tick, a tile, a call) and the
+ * number of heap allocations per iteration, so regressions in either show up in the same table.
+ */
+class BenchmarkSuite
+{
+public:
+    explicit BenchmarkSuite(const BenchmarkConfig& InConfig);
+
+    /**
+     * @brief Parses command line arguments into a suite configuration.
+     * @param Argc The number of arguments.
+     * @param Argv The argument values.
+     * @param OutError Receives a description of the problem if parsing fails.
+     * @return The parsed configuration, or std::nullopt if the arguments are invalid or help was requested.
+     */
+    static std::optional<BenchmarkConfig> ParseCommandLine(int Argc, char** Argv, std::string& OutError);
+
+    /**
+     * @brief Gets the command line usage text.
+     * @param ProgramName The name of the executable.
+     * @return The usage text.
+     */
+    static std::string GetUsage(const std::string& ProgramName);
+
+    /**
+     * @brief Runs all benchmarks that match the filter and prints their results.
+     * @return The process exit code.
+     */
+    int Run();
+
+private:
+    /**
+     * @brief Measured body of a benchmark. Returns the number of units of work it performed.
+     */
+    using BenchmarkBody = std::function<uint64_t()>;
+
+    [[nodiscard]] bool IsSelected(const std::string& Name) const;
+    void Measure(const std::string& Name, const std::string& Unit, const std::string& Iteration, uint64_t Iterations,
+        const std::function<void()>& Setup, const BenchmarkBody& Body);
+
+    void RunUpdateBenchmarks();
+    void RunRandomizeBenchmarks();
+    void RunCommandBenchmarks();
+    void RunStringInternerBenchmarks();
+    void RunApplicationBenchmarks();
+
+    BenchmarkConfig Config;
+    std::vector<BenchmarkResult> Results;
+};
+
+} // namespace Benchmark
+} // namespace CellularSimulator
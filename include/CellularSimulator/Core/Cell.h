@@ -1,6 +1,6 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
-#include <vector>
 
 #include "CellSimulatorTypes.h"
 
@@ -8,50 +8,42 @@ namespace CellularSimulator
 {
 namespace Core
 {
+class CellStore;
 
 /**
  * @class Cell
- * @brief Represents the state of a single living organism.
+ * @brief Handle to the state of a single living organism.
  *
- * This class is a data container for the properties of a cell,
- * such as its energy or genes. It is not aware of its position or color.
- * The existence of a Cell object implies it is "alive".
+ * The properties of a cell, such as its energy or genes, are stored in the
+ * structure-of-arrays CellStore. This class is a lightweight view onto one slot
+ * of that store and is meant to be passed around by value. It is not aware of its color.
  */
 class Cell
 {
 public:
     /**
-     * @brief Default constructor for creating an empty cell in the object pool.
+     * @brief Default constructor for creating an invalid handle.
      */
     Cell() = default;
 
     /**
-     * @brief Constructs a cell with the specified parameters.
-     * @param InX The x-coordinate of the cell.
-     * @param InY The y-coordinate of the cell.
-     * @param InDirection The direction of the cell.
-     * @param InGenome The genome of the cell.
-     * @param InEnergy The energy of the cell.
+     * @brief Constructs a handle to the cell stored in the specified slot.
+     * @param InStore The store that owns the cell state.
+     * @param InId The slot of the cell inside the store.
      */
-    Cell(int32_t InX, int32_t InY, EDirection InDirection, std::vector<size_t> InGenome, float InEnergy, bool InInObjectPool);
-
+    Cell(CellStore* InStore, CellId InId);
 
     /**
-     * @brief Initializes the cell with all the parameters.
-     * @param InX The x-coordinate of the cell.
-     * @param InY The y-coordinate of the cell.
-     * @param InDirection The direction of the cell.
-     * @param InGenome The genome of the cell.
-     * @param InEnergy The energy of the cell.
-     * @param InInObjectPool
+     * @brief Checks if the handle refers to a cell.
+     * @return True if the handle is valid, false otherwise.
      */
-    void Initialize(int32_t InX, int32_t InY, EDirection InDirection, std::vector<size_t> InGenome, float InEnergy, bool InInObjectPool);
+    [[nodiscard]] bool IsValid() const { return Store && Id != InvalidCellId; }
 
     /**
-     * @brief Decides the next command for the cell.
-     * @return The name of the current command from the genome or "None" if the genome is empty.
+     * @brief Gets the slot of the cell inside the store.
+     * @return The id of the cell.
      */
-    size_t DecideNextCommand();
+    [[nodiscard]] CellId GetId() const { return Id; }
 
     /**
      * @brief Gets the x-coordinate of the cell.
@@ -84,16 +76,22 @@ public:
     [[nodiscard]] bool IsAlive() const;
 
     /**
-     * @brief Checks if the cell is in the object pool.
-     * @return True if the cell is in the object pool, false otherwise.
+     * @brief Gets the genome of the cell.
+     * @return The genome of the cell.
      */
-    [[nodiscard]] bool IsInObjectPool() const;
+    [[nodiscard]] GenomeView GetGenome() const;
 
     /**
-     * @brief Gets the genome of the cell.
-     * @return The genome of the cell.
+     * @brief Gets the id of the genome in the genome table, shared by every cell with the same genes.
+     * @return The genome id of the cell.
+     */
+    [[nodiscard]] GenomeId GetGenomeId() const;
+
+    /**
+     * @brief Gets the display color of the genome, cached in the genome table.
+     * @return The color of the cell.
      */
-    [[nodiscard]] const std::vector<size_t>& GetGenome() const;
+    [[nodiscard]] CellColor GetColor() const;
 
     /**
      * @brief Sets the x-coordinate of the cell.
@@ -135,23 +133,18 @@ public:
      * @brief Sets the genome of the cell.
      * @param InGenome The genome of the cell.
      */
-    void SetGenome(std::vector<size_t> InGenome);
+    void SetGenome(GenomeView InGenome);
 
     /**
-     * @brief Set cell in object pool flag.
-     * @param bInObjectPool Cell in object pool flag.
+     * @brief Replaces a single gene of the cell genome.
+     * @param Index The position of the gene in the genome.
+     * @param Gene The new gene.
      */
-    void SetInObjectPool(bool bInObjectPool);
+    void SetGene(size_t Index, Opcode Gene);
 
 private:
-    int32_t X;
-    int32_t Y;
-    EDirection Direction;
-    float Energy;
-    std::vector<size_t> Genome;
-    size_t GenomePointer = 0;
-    float MaxEnergy = 100.0f;
-    bool bInsideObjectPool = true;
+    CellStore* Store = nullptr;
+    CellId Id = InvalidCellId;
 };
 } // namespace Core
-} // namespace CellularSimulator
\ No newline at end of file
+} // namespace CellularSimulator
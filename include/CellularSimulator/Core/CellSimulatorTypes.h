@@ -1,15 +1,109 @@
 ﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 
 namespace CellularSimulator
 {
 namespace Core
 {
 
+/**
+ * @struct CellColor
+ * @brief Renderer-agnostic RGBA color used by the core to describe genes and cells.
+ */
+struct CellColor
+{
+    uint8_t R = 0;
+    uint8_t G = 0;
+    uint8_t B = 0;
+    uint8_t A = 255;
+};
+
+/**
+ * @brief Index of a cell slot inside the simulator cell store.
+ */
+using CellId = uint32_t;
+
+/**
+ * @brief Marks the absence of a cell.
+ */
+constexpr CellId InvalidCellId = std::numeric_limits<CellId>::max();
+
+/**
+ * @brief Index of a distinct genome inside the genome table.
+ */
+using GenomeId = uint32_t;
+
+/**
+ * @brief Marks the absence of a genome.
+ */
+constexpr GenomeId InvalidGenomeId = std::numeric_limits<GenomeId>::max();
+
+/**
+ * @brief A single gene of a genome. Identifies the command to execute.
+ */
+using Opcode = uint8_t;
+
+/**
+ * @class GenomeView
+ * @brief Non-owning read-only view of a contiguous sequence of genes.
+ */
+class GenomeView
+{
+public:
+    GenomeView() = default;
+    GenomeView(const Opcode* InData, size_t InSize) : Data(InData), Size(InSize) {}
+
+    [[nodiscard]] const Opcode* data() const { return Data; }
+    [[nodiscard]] size_t size() const { return Size; }
+    [[nodiscard]] bool empty() const { return Size == 0; }
+    [[nodiscard]] const Opcode* begin() const { return Data; }
+    [[nodiscard]] const Opcode* end() const { return Data + Size; }
+    [[nodiscard]] Opcode operator[](size_t Index) const { return Data[Index]; }
+
+private:
+    const Opcode* Data = nullptr;
+    size_t Size = 0;
+};
+
+/**
+ * @class CellIdView
+ * @brief Non-owning read-only view of a contiguous sequence of cell ids.
+ */
+class CellIdView
+{
+public:
+    CellIdView() = default;
+    CellIdView(const CellId* InData, size_t InSize) : Data(InData), Size(InSize) {}
+
+    [[nodiscard]] const CellId* data() const { return Data; }
+    [[nodiscard]] size_t size() const { return Size; }
+    [[nodiscard]] bool empty() const { return Size == 0; }
+    [[nodiscard]] const CellId* begin() const { return Data; }
+    [[nodiscard]] const CellId* end() const { return Data + Size; }
+    [[nodiscard]] CellId operator[](size_t Index) const { return Data[Index]; }
+
+private:
+    const CellId* Data = nullptr;
+    size_t Size = 0;
+};
+
+/**
+ * @struct TilePosition
+ * @brief The coordinates of a tile of the world grid.
+ */
+struct TilePosition
+{
+    int32_t X = 0;
+    int32_t Y = 0;
+};
+
 /**
  * @enum EDirection
  * @brief Enumerates the directions that a cell can face and do actions in.
  */
-enum class EDirection
+enum class EDirection : uint8_t
 {
     North, // Positive Y axis
     East, // Positive X axis
@@ -0,0 +1,239 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CellSimulatorTypes.h"
+#include "GenomeTable.h"
+
+namespace CellularSimulator
+{
+namespace Core
+{
+
+/**
+ * @class CellStore
+ * @brief Structure-of-arrays storage for the state of all cells.
+ *
+ * Every property lives in its own contiguous array indexed by CellId, so per-tick
+ * passes (energy drain, alive check, command decision) only stream the bytes they use.
+ * Cells refer to their genome by id into a GenomeTable, so the cells sharing a genome
+ * share its genes and its display color, and a child that inherits the genome of its
+ * parent only takes another reference to it.
+ *
+ * Slots are handed out from a free list and keep their id for the whole lifetime of
+ * the cell, so dead cells are never moved out of the way. Only an explicit Reorder
+ * changes the ids of live cells.
+ * Cells are accessed by the rest of the code through the Cell handle.
+ */
+class CellStore
+{
+public:
+    /**
+     * @brief The maximum amount of energy a cell can hold.
+     */
+    static constexpr float MaxEnergy = 100.0f;
+
+    CellStore() = default;
+
+    /**
+     * @brief Resizes every property array to hold the given number of cells and frees all slots.
+     * @param Capacity The number of cell slots.
+     * @param InGenomeLength The number of genes in every genome.
+     */
+    void Resize(size_t Capacity, size_t InGenomeLength);
+
+    /**
+     * @brief Grows every property array, keeping all cells, until the given number of allocations can succeed.
+     * @param Count The number of allocations that have to succeed.
+     * @note Growing moves the arrays, so no pointer into the store may be held across the call.
+     */
+    void EnsureFreeSlots(size_t Count);
+
+    /**
+     * @brief Frees all slots.
+     */
+    void Clear();
+
+    /**
+     * @brief Takes a free slot for a new cell.
+     * @return The id of the slot, or InvalidCellId if the store is full.
+     */
+    CellId Allocate();
+
+    /**
+     * @brief Returns the slot of a dead cell to the free list.
+     * @param Id The slot to free.
+     */
+    void Free(CellId Id);
+
+    /**
+     * @brief Predicts the slot that the given allocation will receive without taking it.
+     *
+     * Lets several threads pick distinct slots for new cells at the same time by drawing
+     * tickets from a shared counter. The slots are taken afterwards with CommitAllocations.
+     * @param Ticket The number of allocations that happen before this one.
+     * @return The id of the slot, or InvalidCellId if the store would be full.
+     */
+    [[nodiscard]] CellId PeekAllocation(size_t Ticket) const;
+
+    /**
+     * @brief Takes the slots previously predicted by PeekAllocation for tickets [0, Count).
+     * @param Count The number of allocations to commit.
+     */
+    void CommitAllocations(size_t Count);
+
+    /**
+     * @brief Gets the number of allocations that can still succeed.
+     * @return The number of free slots.
+     */
+    [[nodiscard]] size_t GetFreeCount() const { return FreeSlots.size() + (GetCapacity() - SlotCount); }
+
+    /**
+     * @brief Gets the number of slots that have ever been handed out. All live cells have smaller ids.
+     * @return The slot high-water mark.
+     */
+    [[nodiscard]] size_t GetSlotCount() const { return SlotCount; }
+
+    /**
+     * @brief Checks if the slot holds a live cell.
+     * @param Id The slot.
+     * @return True if the slot is allocated, false otherwise.
+     */
+    [[nodiscard]] bool IsLive(CellId Id) const { return Id < SlotCount && (LiveBits[Id >> 6] >> (Id & 63)) & 1u; }
+
+    /**
+     * @brief Moves the listed cells to slots [0, Count) in the given order and frees every other slot.
+     * @param Order The ids of the live cells in their new order.
+     * @param Count The number of ids in Order.
+     */
+    void Reorder(const CellId* Order, size_t Count);
+
+    /**
+     * @brief Restores the slot allocation state, e.g. from a snapshot.
+     *
+     * Every slot below the high-water mark that is not listed as free becomes live.
+     * @param InSlotCount The slot high-water mark.
+     * @param InFreeSlots The free slots below the high-water mark, in free list order.
+     * @param FreeCount The number of ids in InFreeSlots.
+     */
+    void RestoreSlots(size_t InSlotCount, const CellId* InFreeSlots, size_t FreeCount);
+
+    /**
+     * @brief Provides read-only access to the free list.
+     * @return The free slots below the high-water mark, the next one to be reused last.
+     */
+    [[nodiscard]] const std::vector<CellId>& GetFreeSlots() const { return FreeSlots; }
+
+    /**
+     * @brief Gets the number of cell slots.
+     * @return The number of cell slots.
+     */
+    [[nodiscard]] size_t GetCapacity() const { return Energy.size(); }
+
+    /**
+     * @brief Gets the number of genes in every genome.
+     * @return The genome length.
+     */
+    [[nodiscard]] size_t GetGenomeLength() const { return GenomeLength; }
+
+    /**
+     * @brief Initializes the cell slot with all the parameters.
+     *
+     * The new cell reads its genome from the first gene. It does not inherit the position of whichever
+     * dead cell used the slot before, which only depended on how slots happened to be reused.
+     * @param Id The slot to initialize.
+     * @param InX The x-coordinate of the cell.
+     * @param InY The y-coordinate of the cell.
+     * @param InDirection The direction of the cell.
+     * @param InGenome The genes of the cell. Interned into the genome table.
+     * @param InEnergy The energy of the cell.
+     */
+    void Initialize(CellId Id, int32_t InX, int32_t InY, EDirection InDirection, GenomeView InGenome, float InEnergy);
+
+    /**
+     * @brief Initializes the cell slot with a genome that is already in the genome table, e.g. inherited from a parent.
+     * @param Id The slot to initialize.
+     * @param InX The x-coordinate of the cell.
+     * @param InY The y-coordinate of the cell.
+     * @param InDirection The direction of the cell.
+     * @param InGenome A referenced genome. The cell takes another reference to it.
+     * @param InEnergy The energy of the cell.
+     */
+    void Initialize(CellId Id, int32_t InX, int32_t InY, EDirection InDirection, GenomeId InGenome, float InEnergy);
+
+    /**
+     * @brief Exchanges the whole state of two cell slots.
+     * @param A The first slot.
+     * @param B The second slot.
+     */
+    void Swap(CellId A, CellId B);
+
+    /**
+     * @brief Decides the next command for the cell and advances its genome pointer.
+     * @param Id The cell slot.
+     * @return The current opcode from the genome or 0 if the genome is empty.
+     */
+    Opcode DecideNextCommand(CellId Id);
+
+    [[nodiscard]] int32_t GetX(CellId Id) const { return X[Id]; }
+    [[nodiscard]] int32_t GetY(CellId Id) const { return Y[Id]; }
+    [[nodiscard]] EDirection GetDirection(CellId Id) const { return Direction[Id]; }
+    [[nodiscard]] float GetEnergy(CellId Id) const { return Energy[Id]; }
+    [[nodiscard]] uint16_t GetGenomePointer(CellId Id) const { return GenomePointer[Id]; }
+    [[nodiscard]] GenomeId GetGenomeId(CellId Id) const { return GenomeIds[Id]; }
+    [[nodiscard]] GenomeView GetGenome(CellId Id) const { return Genomes.GetGenes(GenomeIds[Id]); }
+    [[nodiscard]] CellColor GetColor(CellId Id) const { return Genomes.GetColor(GenomeIds[Id]); }
+
+    void SetX(CellId Id, int32_t InX) { X[Id] = InX; }
+    void SetY(CellId Id, int32_t InY) { Y[Id] = InY; }
+    void SetDirection(CellId Id, EDirection InDirection) { Direction[Id] = InDirection; }
+    void SetEnergy(CellId Id, float InEnergy) { Energy[Id] = InEnergy; }
+    void SetGenomePointer(CellId Id, uint16_t InPointer) { GenomePointer[Id] = InPointer; }
+    void SetGenome(CellId Id, GenomeView InGenome);
+    void SetGene(CellId Id, size_t Index, Opcode Gene);
+
+    /**
+     * @brief Provides direct access to the energy array for bulk passes.
+     * @return A pointer to the first element of the energy array.
+     */
+    [[nodiscard]] float* GetEnergyData() { return Energy.data(); }
+
+    /**
+     * @brief Provides direct read-only access to the energy array for bulk passes.
+     * @return A pointer to the first element of the energy array.
+     */
+    [[nodiscard]] const float* GetEnergyData() const { return Energy.data(); }
+
+    /**
+     * @brief Provides access to the distinct genomes of the cells.
+     * @return The genome table.
+     */
+    [[nodiscard]] GenomeTable& GetGenomeTable() { return Genomes; }
+
+    /**
+     * @brief Provides read-only access to the distinct genomes of the cells.
+     * @return The genome table.
+     */
+    [[nodiscard]] const GenomeTable& GetGenomeTable() const { return Genomes; }
+
+private:
+    GenomeId InternGenome(GenomeView InGenome);
+
+    std::vector<int32_t> X;
+    std::vector<int32_t> Y;
+    std::vector<EDirection> Direction;
+    std::vector<float> Energy;
+    std::vector<uint16_t> GenomePointer;
+    std::vector<GenomeId> GenomeIds;
+    GenomeTable Genomes;
+    size_t GenomeLength = 0;
+
+    std::vector<uint64_t> LiveBits;
+    std::vector<CellId> FreeSlots;
+    size_t SlotCount = 0;
+    std::vector<CellId> ReorderDestination;
+};
+
+} // namespace Core
+} // namespace CellularSimulator
@@ -0,0 +1,183 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "GridTile.h"
+
+namespace CellularSimulator
+{
+namespace Core
+{
+
+/**
+ * @class ChunkedGrid
+ * @brief Sparse storage of the world grid in square chunks that are allocated on demand.
+ *
+ * The tiles of a chunk are stored contiguously in row-major order. A directory covering the bounding
+ * box of the chunks in use maps chunk coordinates to chunk slots, so locating a tile costs two array
+ * lookups, and the box grows when a chunk outside of it is needed. Released chunks return their slot
+ * to a free list for reuse, so memory follows the populated area rather than the area of the world.
+ *
+ * Tiles are addressed by an index that stays valid as long as their chunk is allocated. The grid has
+ * no bounds of its own, the simulator decides which coordinates belong to the world.
+ */
+class ChunkedGrid
+{
+public:
+    static constexpr int32_t ChunkShift = 6;
+    static constexpr int32_t ChunkSize = 1 << ChunkShift;
+    static constexpr size_t TilesPerChunk = size_t{1} << (2 * ChunkShift);
+    static constexpr size_t NoTile = std::numeric_limits<size_t>::max();
+    static constexpr uint32_t NoChunk = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief Converts a tile coordinate to the coordinate of its chunk, rounding towards negative infinity.
+     * @param Coordinate The tile coordinate.
+     * @return The chunk coordinate.
+     */
+    static int32_t ToChunkCoordinate(int32_t Coordinate) { return Coordinate >= 0 ? Coordinate / ChunkSize : (Coordinate + 1) / ChunkSize - 1; }
+
+    /**
+     * @brief Releases every chunk and sizes the directory for the given area of chunks.
+     * @param ChunkCountX The number of chunk columns the directory covers from chunk 0.
+     * @param ChunkCountY The number of chunk rows the directory covers from chunk 0.
+     */
+    void Reset(int32_t ChunkCountX, int32_t ChunkCountY);
+
+    /**
+     * @brief Locates a tile in the allocated chunks.
+     * @param X The x-coordinate of the tile.
+     * @param Y The y-coordinate of the tile.
+     * @return The index of the tile, or NoTile if its chunk is not allocated.
+     */
+    [[nodiscard]] size_t FindTile(int32_t X, int32_t Y) const
+    {
+        const uint32_t Slot = FindChunk(ToChunkCoordinate(X), ToChunkCoordinate(Y));
+        if (Slot == NoChunk) return NoTile;
+        return GetFirstTile(Slot) + GetLocalTile(X, Y);
+    }
+
+    /**
+     * @brief Locates a tile and allocates its chunk if needed.
+     * @param X The x-coordinate of the tile.
+     * @param Y The y-coordinate of the tile.
+     * @return The index of the tile.
+     * @note May reallocate the tile storage, which invalidates references to tiles but not tile indices.
+     */
+    size_t AcquireTile(int32_t X, int32_t Y) { return GetFirstTile(AcquireChunk(ToChunkCoordinate(X), ToChunkCoordinate(Y))) + GetLocalTile(X, Y); }
+
+    GridTile& operator[](size_t TileIndex) { return Tiles[TileIndex]; }
+    const GridTile& operator[](size_t TileIndex) const { return Tiles[TileIndex]; }
+
+    /**
+     * @brief Gets the number of tile indices in use, including those of released chunks.
+     * @return One past the largest tile index.
+     */
+    [[nodiscard]] size_t GetTileCapacity() const { return Tiles.size(); }
+
+    /**
+     * @brief Finds the slot of a chunk.
+     * @param ChunkX The x-coordinate of the chunk.
+     * @param ChunkY The y-coordinate of the chunk.
+     * @return The slot of the chunk, or NoChunk if it is not allocated.
+     */
+    [[nodiscard]] uint32_t FindChunk(int32_t ChunkX, int32_t ChunkY) const
+    {
+        const uint32_t Column = static_cast<uint32_t>(ChunkX - DirectoryMinX);
+        const uint32_t Row = static_cast<uint32_t>(ChunkY - DirectoryMinY);
+        if (Column >= static_cast<uint32_t>(DirectoryWidth) || Row >= static_cast<uint32_t>(DirectoryHeight)) return NoChunk;
+        return Directory[static_cast<size_t>(Row) * DirectoryWidth + Column];
+    }
+
+    /**
+     * @brief Allocates a chunk with empty tiles unless it already exists.
+     * @param ChunkX The x-coordinate of the chunk.
+     * @param ChunkY The y-coordinate of the chunk.
+     * @return The slot of the chunk.
+     */
+    uint32_t AcquireChunk(int32_t ChunkX, int32_t ChunkY);
+
+    /**
+     * @brief Releases a chunk. All of its tiles have to be empty.
+     * @param Slot The slot of the chunk.
+     */
+    void ReleaseChunk(uint32_t Slot);
+
+    /**
+     * @brief Gets the number of chunk slots in use, including released ones.
+     * @return One past the largest chunk slot.
+     */
+    [[nodiscard]] size_t GetChunkSlotCount() const { return Chunks.size(); }
+
+    /**
+     * @brief Gets the number of allocated chunks.
+     * @return The number of chunks.
+     */
+    [[nodiscard]] size_t GetChunkCount() const { return Chunks.size() - FreeChunks.size(); }
+
+    [[nodiscard]] int32_t GetChunkX(uint32_t Slot) const { return Chunks[Slot].X; }
+    [[nodiscard]] int32_t GetChunkY(uint32_t Slot) const { return Chunks[Slot].Y; }
+    [[nodiscard]] static size_t GetFirstTile(uint32_t Slot) { return static_cast<size_t>(Slot) * TilesPerChunk; }
+
+    /**
+     * @brief Gets the world x-coordinate of a tile.
+     * @param TileIndex The index of a tile of an allocated chunk.
+     * @return The x-coordinate.
+     */
+    [[nodiscard]] int32_t GetTileX(size_t TileIndex) const
+    {
+        return Chunks[TileIndex / TilesPerChunk].X * ChunkSize + static_cast<int32_t>(TileIndex & (ChunkSize - 1));
+    }
+
+    /**
+     * @brief Gets the world y-coordinate of a tile.
+     * @param TileIndex The index of a tile of an allocated chunk.
+     * @return The y-coordinate.
+     */
+    [[nodiscard]] int32_t GetTileY(size_t TileIndex) const
+    {
+        return Chunks[TileIndex / TilesPerChunk].Y * ChunkSize + static_cast<int32_t>((TileIndex >> ChunkShift) & (ChunkSize - 1));
+    }
+
+    /**
+     * @brief Visits the allocated chunks ordered by row and then by column, independent of their slots.
+     * @param Function Called with the slot of every chunk.
+     */
+    template <typename TFunction>
+    void ForEachChunk(TFunction&& Function) const
+    {
+        for (const uint32_t Slot : Directory)
+        {
+            if (Slot != NoChunk) Function(Slot);
+        }
+    }
+
+private:
+    struct ChunkInfo
+    {
+        int32_t X = 0;
+        int32_t Y = 0;
+    };
+
+    [[nodiscard]] static size_t GetLocalTile(int32_t X, int32_t Y)
+    {
+        return (static_cast<size_t>(static_cast<uint32_t>(Y) & (ChunkSize - 1)) << ChunkShift) | (static_cast<uint32_t>(X) & (ChunkSize - 1));
+    }
+
+    void GrowDirectory(int32_t ChunkX, int32_t ChunkY);
+
+    std::vector<GridTile> Tiles;
+    std::vector<ChunkInfo> Chunks;
+    std::vector<uint32_t> FreeChunks;
+
+    int32_t DirectoryMinX = 0;
+    int32_t DirectoryMinY = 0;
+    int32_t DirectoryWidth = 0;
+    int32_t DirectoryHeight = 0;
+    std::vector<uint32_t> Directory;
+};
+
+} // namespace Core
+} // namespace CellularSimulator
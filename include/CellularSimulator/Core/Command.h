@@ -1,4 +1,8 @@
 ﻿#pragma once
+#include <cstdint>
+
+#include "CellSimulatorTypes.h"
+#include "WorldTopology.h"
 
 namespace CellularSimulator
 {
@@ -6,6 +10,26 @@ namespace Core
 {
 class Simulator;
 class Cell;
+template <EWorldTopology TTopology>
+class WorldAccessor;
+
+using BoundedWorld = WorldAccessor<EWorldTopology::Bounded>;
+using UnboundedWorld = WorldAccessor<EWorldTopology::Unbounded>;
+using ToroidalWorld = WorldAccessor<EWorldTopology::Toroidal>;
+
+/**
+ * @enum ECommandTarget
+ * @brief Describes which part of the world a command touches besides the agent itself.
+ *
+ * The parallel execution mode uses it to let agents claim the tiles they want to act on,
+ * so that commands which could conflict never run concurrently on the same tile.
+ */
+enum class ECommandTarget : uint8_t
+{
+    Self, // Only reads and writes the agent
+    EmptyForward, // Writes the empty tile in front of the agent (move, spawn)
+    OccupiedForward // Reads and writes the cell in front of the agent
+};
 
 /**
  * @class Command
@@ -17,6 +41,48 @@ public:
     virtual ~Command() = default;
 
     virtual void Execute(Simulator& Sim, Cell& Agent) = 0;
+
+    /**
+     * @brief Executes the command during a tick, in a world whose topology is fixed at compile time.
+     *
+     * The simulator picks the topology once per tick. Commands that look at the grid override these to reach it
+     * through the accessor, which resolves coordinates without checking the topology. The defaults call Execute,
+     * which is enough for commands that only touch their agent.
+     * @param World The grid accessor of the simulator the agent lives in.
+     * @param Agent The agent executing the command.
+     */
+    virtual void ExecuteIn(const BoundedWorld& World, Cell& Agent);
+    virtual void ExecuteIn(const UnboundedWorld& World, Cell& Agent);
+    virtual void ExecuteIn(const ToroidalWorld& World, Cell& Agent);
+
+    /**
+     * @brief Executes the command for every agent of a batch.
+     *
+     * The parallel execution mode groups the agents of a tick by command and hands each group over in
+     * slices, so a command that only touches its agent can run without a virtual call per agent.
+     * Agents of one batch never conflict with each other. The default calls Execute for every agent.
+     * @param Sim The simulator the agents live in.
+     * @param Agents The ids of the agents.
+     */
+    virtual void ExecuteBatch(Simulator& Sim, CellIdView Agents);
+
+    /**
+     * @brief Executes the command for every agent of a batch during a tick, in a world of known topology.
+     *
+     * By default commands that only touch their agent hand the batch to ExecuteBatch, the others call ExecuteIn
+     * for every agent.
+     * @param World The grid accessor of the simulator the agents live in.
+     * @param Agents The ids of the agents.
+     */
+    virtual void ExecuteBatchIn(const BoundedWorld& World, CellIdView Agents);
+    virtual void ExecuteBatchIn(const UnboundedWorld& World, CellIdView Agents);
+    virtual void ExecuteBatchIn(const ToroidalWorld& World, CellIdView Agents);
+
+    /**
+     * @brief Describes the footprint of the command for the parallel execution mode.
+     * @return The part of the world the command touches.
+     */
+    virtual ECommandTarget GetTarget() const { return ECommandTarget::Self; }
 };
 } // namespace Core
 } // namespace CellularSimulator
\ No newline at end of file
@@ -1,49 +1,121 @@
 ﻿#pragma once
+#include <array>
+#include <limits>
 #include <memory>
-#include <unordered_map>
-#include <functional>
 #include <string>
 #include <string_view>
+#include <vector>
+
+#include "CellSimulatorTypes.h"
 
 namespace CellularSimulator
 {
 namespace Core
 {
-enum class EGeneCommand;
 class Command;
 
 /**
  * @class CommandManager
  * @brief Owns a registry of commands and provides access to them.
+ *
+ * Every registered command gets a dense opcode in registration order. Genes store
+ * these opcodes, so dispatching a gene is a single index into a flat table.
  */
 class CommandManager
 {
 public:
+    /**
+     * @brief The maximum number of commands that can be addressed by an opcode.
+     */
+    static constexpr size_t MaxCommands = static_cast<size_t>(std::numeric_limits<Opcode>::max()) + 1;
+
+    /**
+     * @brief Flat opcode-indexed table of commands. Unused opcodes map to nullptr.
+     */
+    using DispatchTable = std::array<Command*, MaxCommands>;
+
     CommandManager() = default;
 
     /**
-     * @brief Provides access to a command by name.
-     * @param CommandNameHash The hash of the command name.
-     * @return A pointer to the created command.
+     * @brief Provides access to a command by opcode.
+     * @param CommandOpcode The opcode of the command.
+     * @return A pointer to the command, or nullptr if no command has this opcode.
      */
-    static Command* GetCommand(size_t CommandNameHash);
+    static Command* GetCommand(Opcode CommandOpcode);
+
+    /**
+     * @brief Provides the opcode-indexed table of all commands for the per-tick dispatch.
+     * @return A reference to the dispatch table.
+     */
+    static const DispatchTable& GetDispatchTable();
 
     /**
      * @brief Registers a command with the factory.
      * @param CommandName The name of the command.
      * @param CommandInstance Pointer to the created command.
+     * @param OutOpcode Receives the opcode of the command. If the name is already registered, the existing opcode.
+     * @return True if the command has an opcode, false if all MaxCommands opcodes are already taken.
+     */
+    static bool RegisterCommand(std::string_view CommandName, std::unique_ptr<Command> CommandInstance, Opcode& OutOpcode);
+
+    /**
+     * @brief Gets the number of registered commands. Valid opcodes are [0, count).
+     * @return The number of registered commands.
+     */
+    static size_t GetRegisteredCommandCount();
+
+    /**
+     * @brief Looks up the opcode of a command by name.
+     * @param CommandName The name of the command.
+     * @param OutOpcode Receives the opcode if the command is registered.
+     * @return True if the command is registered, false otherwise.
+     */
+    static bool FindOpcode(std::string_view CommandName, Opcode& OutOpcode);
+
+    /**
+     * @brief Gets the name of a command by opcode.
+     * @param CommandOpcode The opcode of the command.
+     * @return The name of the command or "UNKNOWN_OPCODE".
+     */
+    static std::string_view GetCommandName(Opcode CommandOpcode);
+
+    /**
+     * @brief Gets the interned hash of the command name by opcode.
+     * @param CommandOpcode The opcode of the command.
+     * @return The interned hash of the name, or the maximum size_t value for unknown opcodes.
+     */
+    static size_t GetCommandNameHash(Opcode CommandOpcode);
+
+    /**
+     * @brief Resolves a genome to the names of its commands.
+     * @param Genome The genome to resolve.
+     * @return The vector of command names.
+     */
+    static std::vector<std::string> ResolveGenome(GenomeView Genome);
+
+    /**
+     * @brief Gets the display color of a gene by opcode.
+     * @param CommandOpcode The opcode of the command.
+     * @return The color captured from the StringInterner gene colors when the command was registered.
      */
-    static void RegisterCommand(std::string_view CommandName, std::unique_ptr<Command> CommandInstance);
+    static CellColor GetGeneColor(Opcode CommandOpcode);
 
     /**
-     * @brief Gets the names of all registered commands.
-     * @return A vector of command names.
+     * @brief Computes the display color of a genome, a position-weighted blend of its gene colors.
+     * @param Genome The genome to color.
+     * @return The color of the genome.
      */
-    static std::vector<size_t> GetRegisteredCommandNamesHashes();
+    static CellColor ComputeGenomeColor(GenomeView Genome);
 
 private:
-    using FactoryMap = std::unordered_map<size_t, std::unique_ptr<Command>>;
-    static FactoryMap& GetRegistry();
+    struct Registry
+    {
+        std::vector<std::unique_ptr<Command>> Commands;
+        std::vector<size_t> NameHashes;
+        DispatchTable Table{};
+        std::array<CellColor, MaxCommands> GeneColors{};
+    };
+    static Registry& GetRegistry();
 };
 
 } // namespace Core
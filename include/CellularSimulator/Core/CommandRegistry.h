@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "CommandManager.h"
+#include <cassert>
 #include <type_traits>
 #include <string_view>
 
@@ -25,7 +26,9 @@ public:
     explicit CommandRegistrar(std::string_view CommandName)
     {
         static_assert(std::is_base_of_v<Command, TCommand>, "TCommand must derive from ICommand");
-        CommandManager::RegisterCommand(CommandName, std::make_unique<TCommand>());
+        Opcode CommandOpcode = 0;
+        [[maybe_unused]] const bool bRegistered = CommandManager::RegisterCommand(CommandName, std::make_unique<TCommand>(), CommandOpcode);
+        assert(bRegistered && "The command registry is full, the command is not registered");
     }
 };
 
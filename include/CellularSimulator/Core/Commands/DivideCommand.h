@@ -14,6 +14,10 @@ class DivideCommand : public Command
 {
 public:
     void Execute(Simulator& Sim, Cell& Agent) override;
+    void ExecuteIn(const BoundedWorld& World, Cell& Agent) override;
+    void ExecuteIn(const UnboundedWorld& World, Cell& Agent) override;
+    void ExecuteIn(const ToroidalWorld& World, Cell& Agent) override;
+    ECommandTarget GetTarget() const override { return ECommandTarget::EmptyForward; }
 };
 
 }  // namespace Core
@@ -14,6 +14,7 @@ class PhotosynthesisCommand : public Command
 {
 public:
     void Execute(Simulator& Sim, Cell& Agent) override;
+    void ExecuteBatch(Simulator& Sim, CellIdView Agents) override;
 };
 } // namespace Core
 } // namespace CellularSimulator
\ No newline at end of file
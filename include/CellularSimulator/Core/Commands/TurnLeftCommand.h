@@ -14,6 +14,7 @@ class TurnLeftCommand : public Command
 {
 public:
     void Execute(Simulator& Sim, Cell& Agent) override;
+    void ExecuteBatch(Simulator& Sim, CellIdView Agents) override;
 };
 
 } // namespace Core
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+
+namespace CellularSimulator
+{
+namespace Core
+{
+
+/**
+ * @enum ERandomStream
+ * @brief Separates the random streams used by different parts of the simulator.
+ */
+enum class ERandomStream : uint64_t
+{
+    Cell, // Streams drawn by commands, keyed by tick and cell id
+    World // Streams drawn while populating the world, keyed by randomization and tile index
+};
+
+/**
+ * @class CounterRng
+ * @brief Stateless counter-based random number generator.
+ *
+ * Every value is a SplitMix64 hash of a key and a counter, and the key itself is derived
+ * from the seed, a stream, a sequence number (e.g. the tick) and an identifier (e.g. the cell).
+ * Two generators built from the same inputs produce the same values on any thread and
+ * in any order, which keeps parallel execution reproducible.
+ */
+class CounterRng
+{
+public:
+    /**
+     * @brief Constructs the generator for the specified inputs.
+     * @param Seed The seed of the simulation.
+     * @param Stream The stream the values belong to.
+     * @param Sequence The sequence number inside the stream, usually the tick.
+     * @param Id The identifier inside the sequence, usually the cell id.
+     */
+    CounterRng(uint64_t Seed, ERandomStream Stream, uint64_t Sequence, uint64_t Id)
+        : Key(Mix(Mix(Mix(Seed ^ static_cast<uint64_t>(Stream) * Gamma) ^ Sequence) ^ Id))
+    {
+    }
+
+    /**
+     * @brief Produces the next 64 random bits.
+     * @return A uniformly distributed 64-bit value.
+     */
+    uint64_t NextU64()
+    {
+        ++Counter;
+        return Mix(Key + Counter * Gamma);
+    }
+
+    /**
+     * @brief Produces the next random float in [0, 1).
+     * @return A uniformly distributed float.
+     */
+    float NextFloat() { return static_cast<float>(NextU64() >> 40) * (1.0f / 16777216.0f); }
+
+    /**
+     * @brief Produces the next random integer in [0, Bound).
+     * @param Bound The exclusive upper bound. Must be positive.
+     * @return A uniformly distributed integer.
+     */
+    uint32_t NextBelow(uint32_t Bound) { return static_cast<uint32_t>(((NextU64() >> 32) * Bound) >> 32); }
+
+private:
+    static constexpr uint64_t Gamma = 0x9E3779B97F4A7C15ull;
+
+    static constexpr uint64_t Mix(uint64_t Value)
+    {
+        Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+        return Value ^ (Value >> 31);
+    }
+
+    uint64_t Key;
+    uint64_t Counter = 0;
+};
+
+} // namespace Core
+} // namespace CellularSimulator
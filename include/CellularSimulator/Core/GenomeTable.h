@@ -0,0 +1,165 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "CellSimulatorTypes.h"
+
+namespace CellularSimulator
+{
+namespace Core
+{
+
+class LineageRecorder;
+
+/**
+ * @class GenomeTable
+ * @brief Hash-consed, reference-counted storage of the distinct genomes of all cells.
+ *
+ * Every distinct sequence of genes is stored once and identified by a GenomeId, so cells sharing
+ * a genome share its genes and its cached display color. The reference count of a genome is the
+ * number of cells carrying it.
+ *
+ * Entries live in fixed-size blocks that never move, so the table grows while other threads read
+ * genes. Interning, adding references and releasing are safe to call from several threads at once.
+ * Releasing the last reference only decrements a counter; unreferenced entries stay findable and are
+ * swept back into the free list once they make up a quarter of the table.
+ */
+class GenomeTable
+{
+public:
+    static constexpr uint32_t BlockShift = 12;
+    static constexpr size_t BlockSize = size_t{1} << BlockShift;
+    static constexpr size_t MaxBlocks = size_t{1} << 16;
+
+    GenomeTable() = default;
+    GenomeTable(const GenomeTable&) = delete;
+    GenomeTable& operator=(const GenomeTable&) = delete;
+
+    /**
+     * @brief Removes every genome.
+     * @param InGenomeLength The number of genes in every genome.
+     */
+    void Reset(size_t InGenomeLength);
+
+    /**
+     * @brief Reports genomes that become carried by a cell and genomes that lose their last cell to a recorder.
+     * @param InLineage The recorder, or nullptr to stop reporting.
+     */
+    void SetLineageRecorder(LineageRecorder* InLineage) { Lineage = InLineage; }
+
+    /**
+     * @brief Finds or adds a genome and takes a reference to it.
+     * @param Genes The genes, exactly GetGenomeLength() of them.
+     * @return The id of the genome.
+     */
+    GenomeId Intern(GenomeView Genes);
+
+    /**
+     * @brief Finds or adds the genome that differs from another one in a single gene and takes a reference to it.
+     * @param Base A referenced genome.
+     * @param Index The index of the gene that differs.
+     * @param Gene The gene at that index.
+     * @return The id of the genome.
+     */
+    GenomeId InternEdited(GenomeId Base, size_t Index, Opcode Gene);
+
+    /**
+     * @brief Takes another reference to a referenced genome.
+     * @param Id The genome.
+     */
+    void AddReference(GenomeId Id) { GetBlock(Id).References[Id & BlockMask].fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Drops a reference to a genome.
+     * @param Id The genome.
+     */
+    void Release(GenomeId Id)
+    {
+        if (GetBlock(Id).References[Id & BlockMask].fetch_sub(1, std::memory_order_relaxed) == 1)
+        {
+            GenomeCount.fetch_sub(1, std::memory_order_relaxed);
+            if (Lineage) ReportExtinction(Id);
+        }
+    }
+
+    [[nodiscard]] GenomeView GetGenes(GenomeId Id) const { return {GetBlock(Id).Genes.get() + (Id & BlockMask) * GenomeLength, GenomeLength}; }
+    [[nodiscard]] CellColor GetColor(GenomeId Id) const { return GetBlock(Id).Colors[Id & BlockMask]; }
+
+    /**
+     * @brief Gets the number of references to a genome, which is the number of cells carrying it.
+     * @param Id The genome.
+     * @return The reference count.
+     */
+    [[nodiscard]] uint32_t GetReferenceCount(GenomeId Id) const { return GetBlock(Id).References[Id & BlockMask].load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets the number of distinct genomes that are referenced.
+     * @return The number of genomes.
+     */
+    [[nodiscard]] size_t GetGenomeCount() const { return GenomeCount.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets the number of genes in every genome.
+     * @return The genome length.
+     */
+    [[nodiscard]] size_t GetGenomeLength() const { return GenomeLength; }
+
+    /**
+     * @brief Visits every referenced genome in order of its id.
+     * @param Function Called with the id of every genome.
+     */
+    template <typename TFunction>
+    void ForEachGenome(TFunction&& Function) const
+    {
+        for (GenomeId Id = 0; Id < EntryCount; ++Id)
+        {
+            const Block& Entries = GetBlock(Id);
+            if (Entries.LiveFlags[Id & BlockMask] && Entries.References[Id & BlockMask].load(std::memory_order_relaxed) > 0) Function(Id);
+        }
+    }
+
+private:
+    static constexpr GenomeId BlockMask = static_cast<GenomeId>(BlockSize - 1);
+    static constexpr size_t NoEdit = std::numeric_limits<size_t>::max();
+
+    struct Block
+    {
+        explicit Block(size_t GenomeLength) : Genes(new Opcode[BlockSize * GenomeLength]) {}
+
+        std::unique_ptr<Opcode[]> Genes;
+        CellColor Colors[BlockSize];
+        uint64_t Hashes[BlockSize];
+        std::atomic<uint32_t> References[BlockSize] = {};
+        uint8_t LiveFlags[BlockSize] = {};
+    };
+
+    [[nodiscard]] Block& GetBlock(GenomeId Id) const { return *Blocks[Id >> BlockShift]; }
+
+    GenomeId InternImpl(const Opcode* Source, GenomeId Base, size_t EditIndex, Opcode EditGene);
+    [[nodiscard]] bool Matches(GenomeId Id, const Opcode* Source, size_t EditIndex, Opcode EditGene) const;
+    GenomeId AllocateEntry();
+    void SweepUnreferenced();
+    void RebuildIndex(size_t IndexSize);
+    void ReportExtinction(GenomeId Id);
+
+    size_t GenomeLength = 0;
+    std::vector<std::unique_ptr<Block>> Blocks;
+    size_t BlockCount = 0;
+    GenomeId EntryCount = 0;
+    std::vector<GenomeId> FreeIds;
+    std::atomic<size_t> GenomeCount = 0;
+
+    // Open addressing with linear probing over every entry that is not free, kept at most half full.
+    std::vector<GenomeId> Index;
+    std::mutex Mutex;
+
+    LineageRecorder* Lineage = nullptr;
+};
+
+} // namespace Core
+} // namespace CellularSimulator
@@ -1,10 +1,11 @@
 #pragma once
 
+#include "CellSimulatorTypes.h"
+
 namespace CellularSimulator
 {
 namespace Core
 {
-class Cell;
 
 /**
  * @class GridTile
@@ -27,30 +28,23 @@ public:
      * @brief Checks if the tile contains a cell.
      * @return True if the tile contains a cell, false otherwise.
      */
-    [[nodiscard]] bool HasCell() const;
-
-    /**
-     * @brief Provides read-write access to the Cell.
-     * @return A non-const pointer to the Cell, or nullptr if none exists.
-     */
-    [[nodiscard]] Cell* GetCell();
-
+    [[nodiscard]] bool HasCell() const { return HostedCell != InvalidCellId; }
 
     /**
-     * @brief Provides read-only access to the Cell.
-     * @return A const pointer to the Cell, or nullptr if none exists.
+     * @brief Provides the id of the hosted cell.
+     * @return The id of the cell, or InvalidCellId if none exists.
      */
-    [[nodiscard]] const Cell* GetCell() const;
+    [[nodiscard]] CellId GetCellId() const { return HostedCell; }
 
     /**
-    * @brief Sets or clears the cell pointer for this tile.
-    * @param InCell A pointer to the cell that now occupies this tile, or nullptr to clear it.
+    * @brief Sets or clears the cell hosted by this tile.
+    * @param InCellId The id of the cell that now occupies this tile, or InvalidCellId to clear it.
     * @note This method should only be called by the Simulator which manages cell ownership.
     */
-    void SetCell(Cell* InCell);
+    void SetCellId(CellId InCellId) { HostedCell = InCellId; }
 
 private:
-    Cell* HostedCell = nullptr;
+    CellId HostedCell = InvalidCellId;
 };
 } // namespace Core
-} // namespace CellularSimulator
\ No newline at end of file
+} // namespace CellularSimulator
@@ -0,0 +1,181 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "CellSimulatorTypes.h"
+
+namespace CellularSimulator
+{
+namespace Core
+{
+
+/**
+ * @class LineageRecorder
+ * @brief Records which genotype descended from which, one record per genotype rather than per cell.
+ *
+ * The genome table reports every genome that becomes carried by a cell, together with the genome it was
+ * mutated from, and every genome that loses its last cell. A genotype stays in memory while it is alive or
+ * has living descendants. Extinct genotypes without living descendants are pruned and never written, so
+ * the output only holds the branches that led somewhere. Extinct ancestors beyond the retention limit are
+ * streamed to disk oldest first, and every remaining genotype is written when the recorder is closed, so
+ * memory stays bounded however many divisions the run performs.
+ *
+ * Genotypes are numbered from 1 at the end of the tick they appear in, in order of their genes, so the
+ * numbering does not depend on the order threads created them in. The recorder is only called by the
+ * genome table under its lock and by the simulator between the phases of a tick.
+ */
+class LineageRecorder
+{
+public:
+    static constexpr uint64_t NotExtinct = std::numeric_limits<uint64_t>::max();
+    static constexpr uint16_t NoMutationSite = std::numeric_limits<uint16_t>::max();
+
+    /**
+     * @struct Record
+     * @brief A genotype as stored in the lineage file. Founders are followed by their genes.
+     */
+    struct Record
+    {
+        uint64_t Genotype = 0;
+        /**
+         * The genotype this one was mutated from, or 0 for a founder.
+         */
+        uint64_t Parent = 0;
+        uint64_t BirthTick = 0;
+        /**
+         * The tick the last cell carrying the genotype died in, or NotExtinct.
+         */
+        uint64_t ExtinctionTick = NotExtinct;
+        /**
+         * The index of the gene that differs from the parent, or NoMutationSite for a founder.
+         */
+        uint16_t MutationSite = NoMutationSite;
+        Opcode OldGene = 0;
+        Opcode NewGene = 0;
+        uint32_t Reserved = 0;
+    };
+
+    LineageRecorder() = default;
+    LineageRecorder(const LineageRecorder&) = delete;
+    LineageRecorder& operator=(const LineageRecorder&) = delete;
+    ~LineageRecorder();
+
+    /**
+     * @brief Creates the lineage file and writes its header.
+     * @param Path The path of the lineage file.
+     * @param InGenomeLength The number of genes in every genome.
+     * @param InMaxRetainedAncestors The number of extinct ancestors kept in memory for pruning before they are written.
+     * @return True if the file was created, false otherwise.
+     */
+    bool Open(const std::string& Path, size_t InGenomeLength, size_t InMaxRetainedAncestors);
+
+    /**
+     * @brief Writes every genotype still in memory and closes the file.
+     * @return True if everything was written, false otherwise.
+     */
+    bool Close();
+
+    /**
+     * @brief Sets the tick that extinctions are attributed to.
+     * @param Tick The tick that is about to run.
+     */
+    void BeginTick(uint64_t Tick) { CurrentTick = Tick; }
+
+    /**
+     * @brief Records a genome that is carried by a cell again or for the first time.
+     * @param Genome The genome.
+     * @param Genes The genes of the genome.
+     * @param Parent The genome it was mutated from, or InvalidGenomeId for a founder.
+     * @param MutationSite The index of the mutated gene. Ignored for founders.
+     * @param OldGene The gene of the parent at the mutation site. Ignored for founders.
+     * @param bNewEntry True if the genome was just added to the table, possibly under the id of an extinct genome.
+     */
+    void OnGenomeAdded(GenomeId Genome, GenomeView Genes, GenomeId Parent, size_t MutationSite, Opcode OldGene, bool bNewEntry);
+
+    /**
+     * @brief Records that the last cell carrying a genome is gone.
+     * @param Genome The genome.
+     */
+    void OnGenomeExtinct(GenomeId Genome);
+
+    /**
+     * @brief Writes every genotype in memory as extinct and starts over, e.g. when the world is cleared.
+     */
+    void OnReset();
+
+    /**
+     * @brief Numbers the genotypes that appeared since the previous tick and streams ancestors beyond the retention limit to disk.
+     * @param Tick The tick that just ran. It becomes the birth tick of the new genotypes.
+     */
+    void EndTick(uint64_t Tick);
+
+    /**
+     * @brief Gets the number of genotypes held in memory.
+     * @return The number of living genotypes and retained ancestors.
+     */
+    [[nodiscard]] size_t GetRetainedCount() const { return Nodes.size() - FreeNodes.size(); }
+
+    /**
+     * @brief Gets the number of genotypes written to the file so far.
+     * @return The number of records.
+     */
+    [[nodiscard]] uint64_t GetWrittenCount() const { return WrittenCount; }
+
+private:
+    static constexpr uint32_t NoNode = std::numeric_limits<uint32_t>::max();
+
+    struct Node
+    {
+        Record Data;
+        // Nodes are reused, so links to other nodes carry the serial the node had when the link was made.
+        uint64_t Serial = 0;
+        uint64_t ParentSerial = 0;
+        uint32_t ParentNode = NoNode;
+        uint32_t RetainedChildren = 0;
+        GenomeId Genome = InvalidGenomeId;
+    };
+
+    struct NodeLink
+    {
+        uint32_t Index = NoNode;
+        uint64_t Serial = 0;
+    };
+
+    [[nodiscard]] bool IsLinked(NodeLink Link) const { return Link.Index < Nodes.size() && Nodes[Link.Index].Serial == Link.Serial; }
+    uint32_t AllocateNode();
+    void FreeNode(uint32_t Index);
+    void MarkExtinct(uint32_t Index);
+    void Prune(uint32_t Index);
+    void NumberNewGenotypes(uint64_t Tick);
+    void WriteNode(uint32_t Index);
+    void WriteRetained(bool bExtinct);
+    void ClearState();
+    void FlushBuffer();
+
+    std::ofstream Stream;
+    size_t GenomeLength = 0;
+    size_t MaxRetainedAncestors = 0;
+    uint64_t CurrentTick = 0;
+
+    std::vector<Node> Nodes;
+    std::vector<Opcode> NodeGenes;
+    std::vector<uint32_t> FreeNodes;
+    std::vector<uint32_t> NodeOfGenome;
+    uint64_t NextSerial = 1;
+    uint64_t NextGenotype = 1;
+
+    std::vector<NodeLink> NewNodes;
+    std::deque<NodeLink> Ancestors;
+    size_t RetainedAncestorCount = 0;
+
+    std::vector<char> Buffer;
+    uint64_t WrittenCount = 0;
+};
+
+} // namespace Core
+} // namespace CellularSimulator
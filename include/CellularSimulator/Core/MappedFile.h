@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace CellularSimulator
+{
+namespace Core
+{
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The operating system pages the file in on demand, so large snapshots can be parsed
+ * without reading them into a separate buffer first.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Maps the specified file, unmapping any previously mapped one.
+     * @param Path The path of the file.
+     * @return True if the file was mapped, false otherwise.
+     */
+    bool Open(const std::string& Path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    void Close();
+
+    /**
+     * @brief Provides access to the mapped bytes.
+     * @return A pointer to the first byte, or nullptr if nothing is mapped.
+     */
+    [[nodiscard]] const uint8_t* GetData() const { return Data; }
+
+    /**
+     * @brief Gets the size of the mapped file.
+     * @return The number of mapped bytes.
+     */
+    [[nodiscard]] size_t GetSize() const { return Size; }
+
+private:
+    const uint8_t* Data = nullptr;
+    size_t Size = 0;
+#ifdef _WIN32
+    void* FileHandle = nullptr;
+    void* MappingHandle = nullptr;
+#endif
+};
+
+} // namespace Core
+} // namespace CellularSimulator
@@ -1,22 +1,56 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
 #include <list>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 #include <cstdint>
-#include <random>
 
+#include "Cell.h"
+#include "CellStore.h"
+#include "ChunkedGrid.h"
+#include "Command.h"
 #include "CommandManager.h"
-
-namespace CellularSimulator::Core
-{
-enum class EDirection;
-}
+#include "CounterRng.h"
+#include "GridTile.h"
+#include "LineageRecorder.h"
+#include "StatisticsRecorder.h"
+#include "TickProfiler.h"
+#include "WorldTopology.h"
 
 namespace CellularSimulator
 {
 namespace Core
 {
-class GridTile;
-class Cell;
+
+/**
+ * @enum EExecutionMode
+ * @brief Selects how the commands of a tick are executed.
+ */
+enum class EExecutionMode : uint8_t
+{
+    /**
+     * Commands run one after another in cell order and observe each other's effects immediately.
+     */
+    Serial,
+    /**
+     * Commands run concurrently, grouped by command. Cells claim the tiles they act on and conflicts are won by the
+     * cell that comes first in cell order, so the result does not depend on the number of threads.
+     */
+    Parallel
+};
+
+/**
+ * @struct GenotypeCount
+ * @brief The number of live cells carrying one genome.
+ */
+struct GenotypeCount
+{
+    GenomeId Genome = InvalidGenomeId;
+    uint32_t Population = 0;
+};
 
 /**
  * @class Simulator
@@ -25,29 +59,75 @@ class Cell;
 class Simulator
 {
 public:
+    /**
+     * @brief The side length in tiles of the square chunks the world is processed in.
+     *
+     * Every tick visits the cells chunk by chunk, so the tiles a command looks at stay in cache.
+     */
+    static constexpr int32_t ChunkSize = ChunkedGrid::ChunkSize;
+
+    /**
+     * @brief The number of extinct ancestors a lineage recording keeps in memory by default.
+     */
+    static constexpr size_t DefaultRetainedAncestors = size_t{1} << 16;
+
     /**
      * @brief Construct the simulator with a grid of the specified size.
+     *
+     * Chunks of the grid are only allocated around cells and released once the cells around them are gone,
+     * so the memory follows the population rather than the size of the world.
      * @param InWidth The width of the grid.
      * @param InHeight The height of the grid.
+     * @param InTopology Whether the grid ends at its size, wraps around or extends without limit.
      */
-    explicit Simulator(int32_t InWidth, int32_t InHeight);
+    explicit Simulator(int32_t InWidth, int32_t InHeight, EWorldTopology InTopology = EWorldTopology::Bounded);
 
     /**
      * @brief Advances the entire simulation by one step.
      */
     void Update();
 
+    /**
+     * @brief Selects how the commands of a tick are executed.
+     * @param InMode The execution mode.
+     */
+    void SetExecutionMode(EExecutionMode InMode) { ExecutionMode = InMode; }
+
+    /**
+     * @brief Gets the execution mode of the commands.
+     * @return The execution mode.
+     */
+    [[nodiscard]] EExecutionMode GetExecutionMode() const { return ExecutionMode; }
+
     /**
      * @brief Clears the grid and populates it with a random distribution of cells.
      * @param Density The probability (0.0 to 1.0) for any tile to contain a cell.
+     * @note Every call draws from a fresh random stream, so successive calls produce different worlds.
      */
     void Randomize(float Density);
 
+    /**
+     * @brief Spawns random cells into the empty tiles of a rectangle, e.g. to seed a colony in a large world.
+     * @param X The x-coordinate of the first tile.
+     * @param Y The y-coordinate of the first tile.
+     * @param RegionWidth The width of the rectangle in tiles.
+     * @param RegionHeight The height of the rectangle in tiles.
+     * @param Density The probability (0.0 to 1.0) for any tile to receive a cell.
+     * @note Draws from the same sequence of random streams as Randomize.
+     */
+    void PopulateRegion(int32_t X, int32_t Y, int32_t RegionWidth, int32_t RegionHeight, float Density);
+
+    /**
+     * @brief Removes every cell and releases every chunk of the grid.
+     */
+    void Clear();
+
     /**
      * @brief Provides read-only access to a specific tile on the grid.
      * @param X The x-coordinate of the tile.
      * @param Y The y-coordinate of the tile.
-     * @return A const pointer to the Tile, or nullptr if coordinates are out of bounds.
+     * @return A pointer to the Tile, or nullptr if the coordinates are outside the world or their chunk is not allocated.
+     * An unallocated tile is empty.
      */
     [[nodiscard]] GridTile* GetTile(int32_t X, int32_t Y);
 
@@ -63,6 +143,18 @@ public:
      */
     [[nodiscard]] int32_t GetHeight() const;
 
+    /**
+     * @brief Gets whether the grid ends at its size, wraps around or extends without limit.
+     * @return The world topology.
+     */
+    [[nodiscard]] EWorldTopology GetTopology() const { return Topology; }
+
+    /**
+     * @brief Gets the number of grid chunks currently holding tiles in memory.
+     * @return The number of allocated chunks.
+     */
+    [[nodiscard]] size_t GetAllocatedChunkCount() const { return Grid.GetChunkCount(); }
+
     /**
      * @brief Checks if the specified tile is valid and empty.
      * @param X The x-coordinate of the tile.
@@ -71,56 +163,520 @@ public:
      */
     [[nodiscard]] bool IsTileValidAndEmpty(int32_t X, int32_t Y) const;
 
+    /**
+     * @brief Provides a handle to the cell with the specified id.
+     * @param Id The id of the cell.
+     * @return A handle to the cell, or an invalid handle if the id does not refer to an active cell.
+     */
+    [[nodiscard]] Cell GetCell(CellId Id);
+
+    /**
+     * @brief Provides direct access to the state of all cells, e.g. for commands that process a whole batch.
+     * @return The cell store.
+     */
+    [[nodiscard]] CellStore& GetCellStore() { return Cells; }
+
+    /**
+     * @brief Writes the cached colors of a rectangle of tiles into a row-major pixel buffer.
+     *
+     * With a step above 1 every pixel covers a Step x Step block of tiles and holds their average color,
+     * so a zoomed-out view costs one pixel per block instead of one per tile.
+     * @param X The x-coordinate of the first tile. Tiles outside the world get the empty color.
+     * @param Y The y-coordinate of the first tile.
+     * @param RegionWidth The width of the rectangle in tiles.
+     * @param RegionHeight The height of the rectangle in tiles.
+     * @param Step The number of tiles per pixel along each axis.
+     * @param OutPixels Receives ceil(RegionWidth / Step) * ceil(RegionHeight / Step) colors.
+     * @param EmptyColor The color of tiles without a cell.
+     */
+    void CopyRegionColors(int32_t X, int32_t Y, int32_t RegionWidth, int32_t RegionHeight, int32_t Step, CellColor* OutPixels, CellColor EmptyColor) const;
+
+    /**
+     * @brief Computes the average cached color of a rectangle of tiles.
+     * @param X The x-coordinate of the first tile. The rectangle must not be empty.
+     * @param Y The y-coordinate of the first tile.
+     * @param RegionWidth The width of the rectangle in tiles.
+     * @param RegionHeight The height of the rectangle in tiles.
+     * @param EmptyColor The color of tiles without a cell.
+     * @return The average color.
+     */
+    [[nodiscard]] CellColor GetRegionColor(int32_t X, int32_t Y, int32_t RegionWidth, int32_t RegionHeight, CellColor EmptyColor) const;
+
+    /**
+     * @brief Enables or disables the tracking of tiles whose color changed.
+     *
+     * While enabled, moves, spawns and deaths mark their tiles dirty until TakeDirtyTiles collects them,
+     * so a renderer can patch only what changed. Enabling it marks every tile dirty.
+     * @param bEnabled True to track dirty tiles.
+     */
+    void SetDirtyTracking(bool bEnabled);
+
+    /**
+     * @brief Marks a tile as changed, e.g. after a command edited the genome of an existing cell.
+     * @param X The x-coordinate of the tile.
+     * @param Y The y-coordinate of the tile.
+     */
+    void MarkTileDirty(int32_t X, int32_t Y);
+
+    /**
+     * @brief Collects and clears the tiles changed since the previous call.
+     * @param OutTiles Receives the positions of the dirty tiles in no particular order.
+     * @return True if every tile has to be considered changed, e.g. after Randomize. OutTiles is empty then.
+     */
+    bool TakeDirtyTiles(std::vector<TilePosition>& OutTiles);
+
     /**
      * @brief Moves a cell to a new location if the tile is valid and empty.
      * @param Agent The cell to move.
      * @param NewX The new x-coordinate of the cell.
      * @param NewY The new y-coordinate of the cell.
      */
-    void MoveCell(Cell* Agent, int32_t NewX, int32_t NewY);
+    void MoveCell(const Cell& Agent, int32_t NewX, int32_t NewY);
 
     /**
      * @brief Spawns a new cell at the specified location.
      * @param X The x-coordinate of the cell.
      * @param Y The y-coordinate of the cell.
      * @param Direction The initial direction of the cell.
-     * @param Genome The genome of the cell.
+     * @param Genome The genes of the cell. Interned into the genome table.
      * @param Energy The initial energy of the cell.
-     * @return A pointer to the newly spawned cell, or nullptr if the tile is not valid or occupied.
+     * @return A handle to the newly spawned cell, or an invalid handle if the tile is not valid or occupied.
      */
-    Cell* SpawnCell(int32_t X, int32_t Y, EDirection Direction, std::vector<size_t> Genome, float Energy);
+    Cell SpawnCell(int32_t X, int32_t Y, EDirection Direction, GenomeView Genome, float Energy);
 
     /**
-     * @brief Returns a reference to the random number generator used by the simulator.
-     * @return A reference to the random number generator.
+     * @brief Spawns a new cell that shares a genome already in the genome table, e.g. the child of a division.
+     * @param X The x-coordinate of the cell.
+     * @param Y The y-coordinate of the cell.
+     * @param Direction The initial direction of the cell.
+     * @param Genome A referenced genome. The new cell takes another reference to it.
+     * @param Energy The initial energy of the cell.
+     * @return A handle to the newly spawned cell, or an invalid handle if the tile is not valid or occupied.
+     */
+    Cell SpawnCell(int32_t X, int32_t Y, EDirection Direction, GenomeId Genome, float Energy);
+
+    /**
+     * @brief Gets the number of genes in every genome.
+     * @return The genome length.
+     */
+    [[nodiscard]] int32_t GetGenomeLength() const { return GenomeLength; }
+
+    /**
+     * @brief Creates the random stream of a cell for the current tick.
+     * @param Id The id of the cell drawing the values.
+     * @return A generator that depends only on the seed, the current tick and the cell id,
+     * so it can be used from any thread with reproducible results.
      */
-    std::mt19937& GetRNG();
+    [[nodiscard]] CounterRng GetRandomStream(CellId Id) const { return {Seed, ERandomStream::Cell, TickCount, Id}; }
+
+    /**
+     * @brief Sets the seed of all random streams of the simulator.
+     * @param InSeed The new seed value.
+     */
+    void SetSeed(uint64_t InSeed);
+
+    /**
+     * @brief Gets the seed of all random streams of the simulator.
+     * @return The seed value.
+     */
+    [[nodiscard]] uint64_t GetSeed() const { return Seed; }
+
+    /**
+     * @brief Gets the number of simulation steps performed so far.
+     * @return The current tick.
+     */
+    [[nodiscard]] uint64_t GetTickCount() const { return TickCount; }
 
     /**
      * @brief Returns the number of active cells in the simulation.
      * @return The number of active cells.
      */
-    size_t GetActiveCellCount() const { return ActiveCellCount; }
+    size_t GetActiveCellCount() const { return ActiveIds.size(); }
+
+    /**
+     * @brief Gets the number of distinct genomes carried by live cells.
+     *
+     * The genotype census is kept up to date by spawns, mutations and deaths, so querying it never scans the cells.
+     * @return The number of genotypes.
+     */
+    [[nodiscard]] size_t GetGenotypeCount() const { return Cells.GetGenomeTable().GetGenomeCount(); }
+
+    /**
+     * @brief Gets the number of live cells carrying a genome.
+     * @param Genome A genome from the census or of a live cell.
+     * @return The population of the genotype.
+     */
+    [[nodiscard]] uint32_t GetGenotypePopulation(GenomeId Genome) const { return Cells.GetGenomeTable().GetReferenceCount(Genome); }
+
+    /**
+     * @brief Gets the genes of a genome from the census.
+     * @param Genome A genome from the census or of a live cell.
+     * @return The genes, valid until the genotype dies out.
+     */
+    [[nodiscard]] GenomeView GetGenotypeGenes(GenomeId Genome) const { return Cells.GetGenomeTable().GetGenes(Genome); }
+
+    /**
+     * @brief Lists the genotypes of the live cells, the most common first.
+     *
+     * Visits the distinct genomes rather than the cells. Genotypes with the same population are ordered by their genes,
+     * so the list does not depend on the order genomes were created in.
+     * @param OutCensus Receives the genotypes with their populations.
+     * @param MaxCount The number of most common genotypes to list, or 0 to list all of them.
+     */
+    void GetGenotypeCensus(std::vector<GenotypeCount>& OutCensus, size_t MaxCount = 0) const;
+
+    /**
+     * @brief Starts recording the lineage of the genotypes to a file.
+     *
+     * The genotypes alive now become founders. Every mutation that creates a new genotype is recorded with its parent,
+     * so recording costs work per genotype rather than per division. Replaces a recording already in progress.
+     * @param Path The path of the lineage file.
+     * @param MaxRetainedAncestors The number of extinct ancestors kept in memory, so that branches dying out later are
+     * pruned instead of written.
+     * @return True if the file was created, false otherwise.
+     */
+    bool StartLineageRecording(const std::string& Path, size_t MaxRetainedAncestors = DefaultRetainedAncestors);
+
+    /**
+     * @brief Writes the genotypes still in memory and stops recording the lineage.
+     * @return True if the whole lineage was written, false otherwise.
+     */
+    bool StopLineageRecording();
+
+    /**
+     * @brief Gets the lineage recording in progress.
+     * @return The recorder, or nullptr if no lineage is being recorded.
+     */
+    [[nodiscard]] const LineageRecorder* GetLineageRecorder() const { return Lineage.get(); }
+
+    /**
+     * @brief Starts streaming the population, energy and event counts of every tick to a CSV file.
+     *
+     * The statistics are gathered by the passes every tick makes anyway and written by a background thread.
+     * Replaces a recording already in progress.
+     * @param Path The path of the CSV file.
+     * @return True if the file was created, false otherwise.
+     */
+    bool StartStatisticsRecording(const std::string& Path);
+
+    /**
+     * @brief Writes the queued statistics and stops recording them.
+     * @return True if every tick was written, false otherwise.
+     */
+    bool StopStatisticsRecording();
+
+    /**
+     * @brief Gets the statistics recording in progress.
+     * @return The recorder, or nullptr if no statistics are being recorded.
+     */
+    [[nodiscard]] const StatisticsRecorder* GetStatisticsRecorder() const { return Statistics.get(); }
+
+    /**
+     * @brief Gets the statistics of the most recent tick that ran while statistics were recorded.
+     * @return The statistics.
+     */
+    [[nodiscard]] const TickStatistics& GetLastTickStatistics() const { return LastStatistics; }
 
     /**
-     * @brief Returns a pointer to the cell at the specified index.
-     * @param Index The index of the cell.
-     * @return A pointer to the cell, or nullptr if the index is out of bounds.
+     * @brief Counts a cell whose last energy a command took, if statistics are recorded.
      */
-    Cell* GetActiveCellByIndex(size_t Index);
+    void RecordKill()
+    {
+        if (Statistics) Statistics->AddKill();
+    }
+
+    /**
+     * @brief Renumbers the live cells so that their ids follow their position in the world, chunk by chunk.
+     *
+     * Cell ids are otherwise stable for the whole lifetime of a cell. Compaction trades that
+     * stability for memory locality of the per-tick passes after many births and deaths.
+     */
+    void CompactCells();
+
+    /**
+     * @brief Sets how often CompactCells runs automatically.
+     * @param Ticks The number of ticks between compactions, or 0 to disable automatic compaction.
+     */
+    void SetCompactionInterval(uint64_t Ticks) { CompactionInterval = Ticks; }
+
+    /**
+     * @brief Sets how far the cell store may drift from the processing order before CompactCells runs automatically.
+     *
+     * Births take whatever slots are free, so over time the cells of a chunk scatter across the store.
+     * The store order is checked every few dozen ticks.
+     * @param Fraction The share of live cells whose slot breaks the processing order, or 0 to disable this trigger.
+     */
+    void SetCompactionThreshold(float Fraction) { CompactionThreshold = Fraction; }
+
+    /**
+     * @brief Returns a handle to the cell at the specified index.
+     * @param Index The index of the cell in the list of active cells.
+     * @return A handle to the cell, or an invalid handle if the index is out of bounds.
+     */
+    Cell GetActiveCellByIndex(size_t Index);
+
+    /**
+     * @brief Writes the complete state of the simulation to a binary snapshot file.
+     *
+     * The snapshot holds the grid size and topology, the random stream state (seed, tick and randomization count),
+     * the cell slots and the genomes. Genes are stored as opcodes together with the table of command
+     * names, so a snapshot stays loadable when commands are registered in a different order.
+     * The file is written next to the destination and renamed over it, so a crash never leaves
+     * a truncated snapshot behind.
+     * @param Path The path of the snapshot file.
+     * @return True if the snapshot was written, false otherwise.
+     */
+    bool SaveSnapshot(const std::string& Path) const;
+
+    /**
+     * @brief Replaces the state of the simulation with the contents of a snapshot file.
+     *
+     * The file is memory mapped and validated before anything is changed. The execution mode and the
+     * compaction interval are settings of the run and are kept. Loading a snapshot and continuing
+     * produces the same ticks as the run that saved it.
+     * @param Path The path of the snapshot file.
+     * @return True if the snapshot was loaded, false if it could not be read or is invalid.
+     */
+    bool LoadSnapshot(const std::string& Path);
+
+    /**
+     * @brief Provides access to the per-tick profiler.
+     * @return The profiler. It only receives records in builds with CELLULAR_SIMULATOR_PROFILING enabled.
+     */
+    [[nodiscard]] TickProfiler& GetProfiler() { return Profiler; }
+
+    /**
+     * @brief Provides read-only access to the per-tick profiler.
+     * @return The profiler.
+     */
+    [[nodiscard]] const TickProfiler& GetProfiler() const { return Profiler; }
 
 private:
+    template <EWorldTopology TTopology>
+    friend class WorldAccessor;
+
+    struct ActionRequest
+    {
+        CellId Agent;
+        Opcode Gene;
+        size_t TargetTile;
+    };
+
+    static constexpr uint32_t UnclaimedTile = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t NoTile = ChunkedGrid::NoTile;
+    static constexpr uint64_t CompactionCheckInterval = 32;
+    static constexpr size_t BatchSliceSize = 1024;
+    static constexpr size_t DrainSliceSize = 16384;
+
+    /**
+     * Wraps the coordinates into the world and locates their tile.
+     * Returns false if they are outside the world, OutTileIndex is NoTile if their chunk is not allocated.
+     */
+    template <EWorldTopology TTopology>
+    [[nodiscard]] bool ResolveTile(int32_t& X, int32_t& Y, size_t& OutTileIndex) const
+    {
+        if (!WorldTopology<TTopology>::Resolve(X, Y, Width, Height)) return false;
+        OutTileIndex = Grid.FindTile(X, Y);
+        return true;
+    }
+    /**
+     * Selects the instantiation for the topology of the world, for callers outside the tick passes.
+     * Their coordinates may lie any distance outside a torus, so they are wrapped with a full modulo.
+     */
+    [[nodiscard]] bool ResolveTile(int32_t& X, int32_t& Y, size_t& OutTileIndex) const
+    {
+        switch (Topology)
+        {
+            case EWorldTopology::Unbounded: return ResolveTile<EWorldTopology::Unbounded>(X, Y, OutTileIndex);
+            case EWorldTopology::Toroidal:
+                WorldTopology<EWorldTopology::Toroidal>::ResolveAny(X, Y, Width, Height);
+                OutTileIndex = Grid.FindTile(X, Y);
+                return true;
+            case EWorldTopology::Bounded: break;
+        }
+        return ResolveTile<EWorldTopology::Bounded>(X, Y, OutTileIndex);
+    }
+    /**
+     * The grid accessors of the tick passes, instantiated per topology. Commands reach them through WorldAccessor.
+     */
+    template <EWorldTopology TTopology>
+    [[nodiscard]] GridTile* GetTile(int32_t X, int32_t Y)
+    {
+        size_t TileIndex;
+        if (!ResolveTile<TTopology>(X, Y, TileIndex) || TileIndex == NoTile) return nullptr;
+        return &Grid[TileIndex];
+    }
+    template <EWorldTopology TTopology>
+    [[nodiscard]] bool IsTileValidAndEmpty(int32_t X, int32_t Y) const
+    {
+        size_t TileIndex;
+        return ResolveTile<TTopology>(X, Y, TileIndex) && (TileIndex == NoTile || !Grid[TileIndex].HasCell());
+    }
+    template <EWorldTopology TTopology>
+    void MoveCell(const Cell& Agent, int32_t NewX, int32_t NewY)
+    {
+        size_t NewTileIndex;
+        if (ResolveTile<TTopology>(NewX, NewY, NewTileIndex)) MoveCellToTile(Agent, NewX, NewY, NewTileIndex);
+    }
+    template <EWorldTopology TTopology>
+    Cell SpawnCell(int32_t X, int32_t Y, EDirection Direction, GenomeId Genome, float Energy)
+    {
+        size_t TileIndex;
+        if (!ResolveTile<TTopology>(X, Y, TileIndex)) return {};
+        return SpawnCellAtTile(X, Y, TileIndex, Direction, Genome, Energy);
+    }
+    [[nodiscard]] bool IsInsideWorld(int32_t X, int32_t Y) const
+    {
+        return Topology == EWorldTopology::Unbounded || (X >= 0 && X < Width && Y >= 0 && Y < Height);
+    }
+    bool ResolveChunk(int32_t& ChunkX, int32_t& ChunkY) const;
+    /**
+     * Orders tiles by row and then by column, independent of the chunk slots they live in.
+     */
+    [[nodiscard]] static uint64_t GetPositionKey(int32_t X, int32_t Y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(Y) ^ 0x80000000u) << 32) | (static_cast<uint32_t>(X) ^ 0x80000000u);
+    }
+
+    void ResizeWorld(int32_t InWidth, int32_t InHeight);
+    size_t AcquireTile(int32_t X, int32_t Y);
+    void GrowTileState();
+    void UpdateChunkResidency();
+    const GridTile* FindTileRun(int32_t X, int32_t Y, int32_t& InOutEndX) const;
+    void MarkTileIndexDirty(size_t TileIndex)
+    {
+        if (!bTrackDirtyTiles) return;
+        DirtyBits[TileIndex >> 6].fetch_or(uint64_t{1} << (TileIndex & 63), std::memory_order_relaxed);
+        bAnyTileDirty.store(true, std::memory_order_relaxed);
+    }
+    void MarkAllTilesDirty() { bAllTilesDirty.store(true, std::memory_order_relaxed); }
+    template <typename TFunction>
+    static void ForEachTileByChunk(int32_t RegionX, int32_t RegionY, int32_t RegionWidth, int32_t RegionHeight, TFunction&& Function)
+    {
+        const int32_t RegionEndX = RegionX + RegionWidth;
+        const int32_t RegionEndY = RegionY + RegionHeight;
+        const int32_t FirstChunkX = ChunkedGrid::ToChunkCoordinate(RegionX) * ChunkSize;
+        const int32_t FirstChunkY = ChunkedGrid::ToChunkCoordinate(RegionY) * ChunkSize;
+        for (int32_t ChunkY = FirstChunkY; ChunkY < RegionEndY; ChunkY += ChunkSize)
+        {
+            const int32_t ChunkEndY = std::min(ChunkY + ChunkSize, RegionEndY);
+            for (int32_t ChunkX = FirstChunkX; ChunkX < RegionEndX; ChunkX += ChunkSize)
+            {
+                const int32_t ChunkEndX = std::min(ChunkX + ChunkSize, RegionEndX);
+                for (int32_t Y = std::max(ChunkY, RegionY); Y < ChunkEndY; ++Y)
+                {
+                    for (int32_t X = std::max(ChunkX, RegionX); X < ChunkEndX; ++X)
+                    {
+                        Function(X, Y);
+                    }
+                }
+            }
+        }
+    }
+    size_t CollectActiveCellsByChunk();
+    template <EWorldTopology TTopology>
+    void ExecuteCommands();
+    template <EWorldTopology TTopology>
+    void ExecuteSerial();
+    template <EWorldTopology TTopology>
+    void ExecuteParallel();
+    template <EWorldTopology TTopology>
+    size_t FindTargetTile(CellId Agent, ECommandTarget Target) const;
+    void BucketRequestsByOpcode();
+    template <EWorldTopology TTopology, typename TFilter>
+    void ExecuteBatches(const WorldAccessor<TTopology>& World, TFilter&& ShouldRun);
+    template <EWorldTopology TTopology>
+    void ExecuteBatch(Command& Cmd, const WorldAccessor<TTopology>& World, const CellId* Agents, size_t Count);
+    void ClaimTile(size_t TileIndex, uint32_t RequestIndex);
+    [[nodiscard]] bool IsClaimedBy(size_t TileIndex, uint32_t RequestIndex) const;
+    void MoveCellToTile(const Cell& Agent, int32_t NewX, int32_t NewY, size_t NewTileIndex);
+    Cell SpawnCellAtTile(int32_t X, int32_t Y, size_t TileIndex, EDirection Direction, GenomeId Genome, float Energy);
+    template <typename TGenome>
+    Cell SpawnCellWithGenome(int32_t X, int32_t Y, size_t TileIndex, EDirection Direction, TGenome Genome, float Energy);
+    void CommitParallelSpawns();
+    void RemoveDeadCells();
+    void DrainEnergy(size_t CellsBeforeExecute);
+    void RestoreNewbornEnergy(size_t CellsBeforeExecute);
+
     int32_t Width = 256;
     int32_t Height = 256;
-    std::vector<GridTile> Grid;
-    std::vector<Cell> CellPool;
-    size_t ActiveCellCount = 0;
+    EWorldTopology Topology = EWorldTopology::Bounded;
+    ChunkedGrid Grid;
+    std::vector<uint32_t> ChunkPopulation;
+    std::vector<uint32_t> ReleasedChunks;
+    std::vector<std::pair<int32_t, int32_t>> MissingChunks;
+    CellStore Cells;
+    std::vector<CellId> ActiveIds;
+    uint64_t CompactionInterval = 0;
+    float CompactionThreshold = 0.25f;
+    std::vector<ActionRequest> Requests;
+    std::vector<size_t> BucketOffsets;
+    std::vector<size_t> BucketCursors;
+    std::vector<uint32_t> BucketedRequests;
+    std::vector<CellId> BucketedAgents;
+    std::vector<CellId> BatchAgents;
+    std::vector<size_t> BatchSlices;
+
+    EExecutionMode ExecutionMode = EExecutionMode::Serial;
+    std::vector<std::atomic<uint32_t>> TileClaims;
+    bool bDeferSpawnCount = false;
+    std::atomic<size_t> PendingSpawnCount = 0;
+    std::vector<CellId> SpawnSlots;
+    std::vector<std::pair<uint64_t, CellId>> SpawnOrder;
+    std::vector<uint32_t> SpawnDestination;
+    std::vector<float> NewbornEnergy;
+
+    bool bTrackDirtyTiles = false;
+    std::vector<std::atomic<uint64_t>> DirtyBits;
+    std::vector<TilePosition> ReleasedDirtyTiles;
+    std::atomic<bool> bAnyTileDirty = false;
+    std::atomic<bool> bAllTilesDirty = true;
 
     CommandManager CmdManager;
 
     int32_t GenomeLength = 16;
 
-    std::mt19937 RandomGenerator;
+    uint64_t Seed = 5489u;
+    uint64_t TickCount = 0;
+    uint64_t RandomizeCount = 0;
+
+    TickProfiler Profiler;
+
+    std::unique_ptr<LineageRecorder> Lineage;
+
+    std::unique_ptr<StatisticsRecorder> Statistics;
+    TickStatistics LastStatistics;
+    std::vector<std::pair<double, uint64_t>> DrainPartials;
+};
+
+/**
+ * @class WorldAccessor
+ * @brief Gives commands access to the grid of a simulator whose topology is known at compile time.
+ *
+ * It offers the grid functions of Simulator that commands use, but resolves coordinates through the
+ * instantiation for its topology. Coordinates are expected to be at most one world size outside the world,
+ * as those of neighbours are.
+ */
+template <EWorldTopology TTopology>
+class WorldAccessor
+{
+public:
+    explicit WorldAccessor(Simulator& InSim) : Sim(InSim) {}
+
+    [[nodiscard]] Simulator& GetSimulator() const { return Sim; }
+    [[nodiscard]] GridTile* GetTile(int32_t X, int32_t Y) const { return Sim.GetTile<TTopology>(X, Y); }
+    [[nodiscard]] bool IsTileValidAndEmpty(int32_t X, int32_t Y) const { return Sim.IsTileValidAndEmpty<TTopology>(X, Y); }
+    [[nodiscard]] Cell GetCell(CellId Id) const { return Sim.GetCell(Id); }
+    void MoveCell(const Cell& Agent, int32_t NewX, int32_t NewY) const { Sim.MoveCell<TTopology>(Agent, NewX, NewY); }
+    Cell SpawnCell(int32_t X, int32_t Y, EDirection Direction, GenomeId Genome, float Energy) const
+    {
+        return Sim.SpawnCell<TTopology>(X, Y, Direction, Genome, Energy);
+    }
+    [[nodiscard]] CounterRng GetRandomStream(CellId Id) const { return Sim.GetRandomStream(Id); }
+    void RecordKill() const { Sim.RecordKill(); }
+
+private:
+    Simulator& Sim;
 };
 } // namespace Core
 } // namespace CellularSimulator
\ No newline at end of file
@@ -0,0 +1,147 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CellSimulatorTypes.h"
+#include "CommandManager.h"
+
+namespace CellularSimulator
+{
+namespace Core
+{
+
+/**
+ * @struct TickStatistics
+ * @brief The population and event counts of a single tick.
+ */
+struct TickStatistics
+{
+    /**
+     * @brief The tick the record belongs to.
+     */
+    uint64_t Tick = 0;
+    /**
+     * @brief The number of cells alive at the end of the tick.
+     */
+    uint64_t Population = 0;
+    /**
+     * @brief The energy of all cells alive at the end of the tick.
+     */
+    double TotalEnergy = 0.0;
+    /**
+     * @brief The number of cells born during the tick.
+     */
+    uint64_t Births = 0;
+    /**
+     * @brief The number of cells that died during the tick.
+     */
+    uint64_t Deaths = 0;
+    /**
+     * @brief The number of successful moves during the tick.
+     */
+    uint64_t Moves = 0;
+    /**
+     * @brief The number of cells whose last energy was eaten during the tick.
+     */
+    uint64_t Kills = 0;
+    /**
+     * @brief The number of cells that read each gene at the start of the tick.
+     */
+    std::array<uint64_t, CommandManager::MaxCommands> OpcodeCounts{};
+};
+
+/**
+ * @class StatisticsRecorder
+ * @brief Streams per-tick statistics to a CSV file from a background thread.
+ *
+ * The simulator fills a record from the passes a tick already makes and hands it over at the end of the tick.
+ * Rows are formatted and written by a writer thread, so a slow disk never stalls the simulation. Events that
+ * commands report while running in parallel go to per-thread counters that are summed once per tick.
+ */
+class StatisticsRecorder
+{
+public:
+    StatisticsRecorder() = default;
+    StatisticsRecorder(const StatisticsRecorder&) = delete;
+    StatisticsRecorder& operator=(const StatisticsRecorder&) = delete;
+    ~StatisticsRecorder();
+
+    /**
+     * @brief Creates the CSV file, writes its header and starts the writer thread.
+     * @param Path The path of the CSV file.
+     * @return True if the file was created, false otherwise.
+     */
+    bool Open(const std::string& Path);
+
+    /**
+     * @brief Writes the records still queued, stops the writer thread and closes the file.
+     * @return True if every record was written, false otherwise.
+     */
+    bool Close();
+
+    void AddMove() { GetThreadCounters().Moves.fetch_add(1, std::memory_order_relaxed); }
+    void AddKill() { GetThreadCounters().Kills.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Moves the events counted since the previous call into a record.
+     * @param OutStatistics Receives the moves and kills.
+     */
+    void TakeEvents(TickStatistics& OutStatistics);
+
+    /**
+     * @brief Queues a record for the writer thread.
+     * @param Statistics The completed record of a tick.
+     */
+    void Submit(const TickStatistics& Statistics);
+
+    /**
+     * @brief Gets the number of records submitted so far.
+     * @return The number of ticks recorded.
+     */
+    [[nodiscard]] uint64_t GetSubmittedCount() const { return SubmittedCount; }
+
+private:
+    static constexpr size_t CounterSlotCount = 64;
+
+    // Padded to a cache line, so threads counting at the same time do not share one. Threads beyond the
+    // number of slots share them, which the atomics keep correct.
+    struct alignas(64) ThreadCounters
+    {
+        std::atomic<uint64_t> Moves = 0;
+        std::atomic<uint64_t> Kills = 0;
+    };
+
+    ThreadCounters& GetThreadCounters()
+    {
+        // Every thread keeps its slot for its lifetime, whichever recorder it counts for.
+        thread_local const size_t Slot = NextCounterSlot.fetch_add(1, std::memory_order_relaxed) % CounterSlotCount;
+        return Counters[Slot];
+    }
+
+    void WriterLoop();
+    void WriteRecords(const std::vector<TickStatistics>& Records);
+
+    static std::atomic<size_t> NextCounterSlot;
+    std::array<ThreadCounters, CounterSlotCount> Counters;
+
+    std::ofstream Stream;
+    size_t OpcodeCount = 0;
+    std::thread Writer;
+    std::mutex Mutex;
+    std::condition_variable WorkAvailable;
+    std::vector<TickStatistics> Pending;
+    bool bStopping = false;
+    uint64_t SubmittedCount = 0;
+    std::string Row;
+};
+
+} // namespace Core
+} // namespace CellularSimulator
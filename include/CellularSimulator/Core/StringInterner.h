@@ -3,8 +3,9 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
-#include "raylib.h"
+#include "CellSimulatorTypes.h"
 
 namespace CellularSimulator
 {
@@ -22,7 +23,7 @@ public:
     StringInterner& operator=(const StringInterner&) = delete;
 
     /**
-     * @brief Initializes the gene color map. Should be called once at the start
+     * @brief Initializes the gene color map. Called on construction, calling it again restores the default colors
      */
     void InitializeGeneColors();
     /**
@@ -45,26 +46,19 @@ public:
      */
     std::string_view Resolve(size_t Hash) const;
 
-    /**
-     * @brief Resolves a vector of hash values to their original strings
-     * @param Genome The vector of hash values to resolve
-     * @return The vector of original strings associated with the hash values
-     */
-    std::vector<std::string> ResolveGenome(const std::vector<size_t>& Genome) const;
-
     /**
      * @brief Retrieves the color associated with a gene hash value
      * @param Hash The hash value of the gene
      * @return The color associated with the gene hash value
      */
-    Color GetGeneColor(size_t Hash) const;
+    CellColor GetGeneColor(size_t Hash) const;
 
 private:
-    StringInterner() = default;
+    StringInterner();
     std::unordered_map<std::string, size_t> StringToHash;
     std::unordered_map<size_t, std::string> HashToString;
-    std::map<size_t, Color> GeneColorMap;
-    Color DefaultColor = BLACK;
+    std::map<size_t, CellColor> GeneColorMap;
+    CellColor DefaultColor = {0, 0, 0, 255};
 };
 } // namespace Core
 } // namespace CellularSimulator
\ No newline at end of file
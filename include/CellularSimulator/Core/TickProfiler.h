@@ -0,0 +1,222 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Profiling of the simulation ticks is compiled in only when CELLULAR_SIMULATOR_PROFILING is non-zero
+ * (CMake option CELLULAR_SIMULATOR_ENABLE_PROFILING). Otherwise the instrumentation macros expand to nothing
+ * and the profiler stays empty.
+ */
+#ifndef CELLULAR_SIMULATOR_PROFILING
+#define CELLULAR_SIMULATOR_PROFILING 0
+#endif
+
+#define CELLULAR_SIMULATOR_PROFILE_CONCAT_INNER(A, B) A##B
+#define CELLULAR_SIMULATOR_PROFILE_CONCAT(A, B) CELLULAR_SIMULATOR_PROFILE_CONCAT_INNER(A, B)
+
+#if CELLULAR_SIMULATOR_PROFILING
+/**
+ * Runs the statement only in profiling builds.
+ */
+#define CELLULAR_SIMULATOR_PROFILE(Statement) Statement
+/**
+ * Attributes the rest of the enclosing scope to a phase of the current tick.
+ */
+#define CELLULAR_SIMULATOR_PROFILE_PHASE(Profiler, Phase) \
+    const ::CellularSimulator::Core::TickProfiler::ScopedPhase CELLULAR_SIMULATOR_PROFILE_CONCAT(ProfilePhase, __LINE__)(Profiler, Phase)
+#else
+#define CELLULAR_SIMULATOR_PROFILE(Statement)
+#define CELLULAR_SIMULATOR_PROFILE_PHASE(Profiler, Phase)
+#endif
+
+namespace CellularSimulator
+{
+namespace Core
+{
+
+/**
+ * @enum ETickPhase
+ * @brief The phases of a simulation tick, in execution order.
+ */
+enum class ETickPhase : uint8_t
+{
+    Decide, // Every cell reads its next gene
+    Execute, // Commands run, serially or in parallel
+    EnergyDrain, // Every cell pays the energy cost of the tick
+    RemoveDead, // Cells without energy leave the grid
+    Compact, // Optional spatial reordering of the cell store
+    Count
+};
+
+/**
+ * @struct TickProfile
+ * @brief Timings and event counts of a single tick.
+ */
+struct TickProfile
+{
+    static constexpr size_t PhaseCount = static_cast<size_t>(ETickPhase::Count);
+
+    /**
+     * @brief The tick the record belongs to.
+     */
+    uint64_t Tick = 0;
+    /**
+     * @brief The start of the tick in nanoseconds since the profiler was created.
+     */
+    uint64_t StartNs = 0;
+    /**
+     * @brief The duration of the whole tick in nanoseconds.
+     */
+    uint64_t DurationNs = 0;
+    /**
+     * @brief The start of every phase in nanoseconds since the profiler was created, or 0 if the phase did not run.
+     */
+    std::array<uint64_t, PhaseCount> PhaseStartNs{};
+    /**
+     * @brief The duration of every phase in nanoseconds.
+     */
+    std::array<uint64_t, PhaseCount> PhaseDurationNs{};
+    /**
+     * @brief The number of cells that were alive at the start of the tick.
+     */
+    uint64_t Cells = 0;
+    /**
+     * @brief The number of cells born during the tick.
+     */
+    uint64_t Spawns = 0;
+    /**
+     * @brief The number of cells that died during the tick.
+     */
+    uint64_t Deaths = 0;
+    /**
+     * @brief The number of successful moves during the tick.
+     */
+    uint64_t Moves = 0;
+};
+
+/**
+ * @class TickProfiler
+ * @brief Records per-phase durations and event counts of the most recent ticks.
+ *
+ * Records live in a fixed-size ring, so a profiling build can run indefinitely and the
+ * history is dumped on demand as a Chrome trace (chrome://tracing, Perfetto) or as CSV.
+ * Event counters may be incremented from several threads during the parallel execution phase.
+ */
+class TickProfiler
+{
+public:
+    /**
+     * @brief Measures the lifetime of a scope as a phase of the current tick.
+     */
+    class ScopedPhase
+    {
+    public:
+        ScopedPhase(TickProfiler& InProfiler, ETickPhase InPhase) : Profiler(InProfiler), Phase(InPhase) { Profiler.BeginPhase(Phase); }
+        ~ScopedPhase() { Profiler.EndPhase(Phase); }
+
+        ScopedPhase(const ScopedPhase&) = delete;
+        ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    private:
+        TickProfiler& Profiler;
+        ETickPhase Phase;
+    };
+
+    /**
+     * @brief Constructs the profiler.
+     * @param InCapacity The number of most recent ticks to keep.
+     */
+    explicit TickProfiler(size_t InCapacity = 4096);
+
+    /**
+     * @brief Checks if the profiling instrumentation is compiled in.
+     * @return True in profiling builds, false otherwise.
+     */
+    static constexpr bool IsEnabled() { return CELLULAR_SIMULATOR_PROFILING != 0; }
+
+    /**
+     * @brief Gets the display name of a phase.
+     * @param Phase The phase.
+     * @return The name of the phase.
+     */
+    static const char* GetPhaseName(ETickPhase Phase);
+
+    /**
+     * @brief Changes the number of ticks kept and drops the recorded history.
+     * @param InCapacity The number of most recent ticks to keep.
+     */
+    void SetCapacity(size_t InCapacity);
+
+    /**
+     * @brief Drops the recorded history.
+     */
+    void Clear();
+
+    /**
+     * @brief Starts the record of a tick.
+     * @param Tick The tick about to run.
+     * @param Cells The number of live cells at the start of the tick.
+     */
+    void BeginTick(uint64_t Tick, uint64_t Cells);
+
+    /**
+     * @brief Completes the record of the current tick and moves it into the history.
+     */
+    void EndTick();
+
+    void BeginPhase(ETickPhase Phase);
+    void EndPhase(ETickPhase Phase);
+
+    void AddSpawns(uint64_t Count) { PendingSpawns.fetch_add(Count, std::memory_order_relaxed); }
+    void AddDeaths(uint64_t Count) { PendingDeaths.fetch_add(Count, std::memory_order_relaxed); }
+    void AddMoves(uint64_t Count) { PendingMoves.fetch_add(Count, std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets the number of ticks in the history.
+     * @return The number of records.
+     */
+    [[nodiscard]] size_t GetRecordCount() const { return RecordCount; }
+
+    /**
+     * @brief Provides access to a record of the history.
+     * @param Index The index of the record, 0 being the oldest.
+     * @return The record.
+     */
+    [[nodiscard]] const TickProfile& GetRecord(size_t Index) const;
+
+    /**
+     * @brief Writes the history in the Chrome trace event format.
+     * @param Path The path of the JSON file.
+     * @return True if the file was written, false otherwise.
+     */
+    bool WriteChromeTrace(const std::string& Path) const;
+
+    /**
+     * @brief Writes the history as CSV, one row per tick.
+     * @param Path The path of the CSV file.
+     * @return True if the file was written, false otherwise.
+     */
+    bool WriteCsv(const std::string& Path) const;
+
+private:
+    [[nodiscard]] uint64_t GetTimeNs() const;
+
+    std::chrono::steady_clock::time_point Epoch;
+    std::vector<TickProfile> Records;
+    size_t Capacity;
+    size_t NextRecord = 0;
+    size_t RecordCount = 0;
+
+    TickProfile Current;
+    std::atomic<uint64_t> PendingSpawns = 0;
+    std::atomic<uint64_t> PendingDeaths = 0;
+    std::atomic<uint64_t> PendingMoves = 0;
+};
+
+} // namespace Core
+} // namespace CellularSimulator
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+
+namespace CellularSimulator
+{
+namespace Core
+{
+
+/**
+ * @enum EWorldTopology
+ * @brief Selects which coordinates belong to the world.
+ */
+enum class EWorldTopology : uint8_t
+{
+    /**
+     * Only the tiles of the width x height rectangle exist. Cells cannot move or divide past its border.
+     */
+    Bounded,
+    /**
+     * Every coordinate exists. The width x height rectangle is only the area Randomize populates.
+     */
+    Unbounded,
+    /**
+     * The width x height rectangle wraps around at its borders, so the world has no edges.
+     */
+    Toroidal
+};
+
+/**
+ * @struct WorldTopology
+ * @brief Maps coordinates onto the tiles of a world with the given topology.
+ *
+ * The topology is a template parameter, so code instantiated for one topology resolves
+ * neighbour coordinates without checking which topology the world has.
+ */
+template <EWorldTopology TTopology>
+struct WorldTopology;
+
+template <>
+struct WorldTopology<EWorldTopology::Bounded>
+{
+    /**
+     * @brief Checks that coordinates lie inside the world.
+     * @param X The x-coordinate.
+     * @param Y The y-coordinate.
+     * @param Width The width of the world.
+     * @param Height The height of the world.
+     * @return True if the tile exists.
+     */
+    static bool Resolve(int32_t& X, int32_t& Y, int32_t Width, int32_t Height)
+    {
+        // Negative coordinates become huge unsigned values, so one comparison per axis covers both borders.
+        return static_cast<uint32_t>(X) < static_cast<uint32_t>(Width) && static_cast<uint32_t>(Y) < static_cast<uint32_t>(Height);
+    }
+};
+
+template <>
+struct WorldTopology<EWorldTopology::Unbounded>
+{
+    static bool Resolve(int32_t&, int32_t&, int32_t, int32_t) { return true; }
+};
+
+template <>
+struct WorldTopology<EWorldTopology::Toroidal>
+{
+    /**
+     * @brief Wraps coordinates into the world.
+     * @param X The x-coordinate, at most one world width outside the world. Receives the wrapped coordinate.
+     * @param Y The y-coordinate, at most one world height outside the world. Receives the wrapped coordinate.
+     * @param Width The width of the world.
+     * @param Height The height of the world.
+     * @return Always true, every coordinate maps to a tile.
+     */
+    static bool Resolve(int32_t& X, int32_t& Y, int32_t Width, int32_t Height)
+    {
+        X = Wrap(X, Width);
+        Y = Wrap(Y, Height);
+        return true;
+    }
+
+    static int32_t Wrap(int32_t Value, int32_t Size)
+    {
+        // Neighbours are one step away, so adding or subtracting the size once is enough, and compiles to conditional moves.
+        Value += Value < 0 ? Size : 0;
+        Value -= Value >= Size ? Size : 0;
+        return Value;
+    }
+
+    /**
+     * @brief Wraps arbitrary coordinates into the world, e.g. coordinates passed in by a caller outside the tick passes.
+     * @param X The x-coordinate. Receives the wrapped coordinate.
+     * @param Y The y-coordinate. Receives the wrapped coordinate.
+     * @param Width The width of the world.
+     * @param Height The height of the world.
+     * @return Always true, every coordinate maps to a tile.
+     */
+    static bool ResolveAny(int32_t& X, int32_t& Y, int32_t Width, int32_t Height)
+    {
+        X = WrapAny(X, Width);
+        Y = WrapAny(Y, Height);
+        return true;
+    }
+
+    static int32_t WrapAny(int32_t Value, int32_t Size)
+    {
+        // The remainder keeps the sign of the value, so it is at most one size below zero.
+        return Wrap(Value % Size, Size);
+    }
+};
+
+} // namespace Core
+} // namespace CellularSimulator
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "CellularSimulator/Core/Simulator.h"
+
+namespace CellularSimulator
+{
+namespace Headless
+{
+
+/**
+ * @struct BatchConfig
+ * @brief Parameters of a single headless simulation run.
+ */
+struct BatchConfig
+{
+    /**
+     * @brief The width of the simulation grid.
+     */
+    int32_t Width = 300;
+    /**
+     * @brief The height of the simulation grid.
+     */
+    int32_t Height = 300;
+    /**
+     * @brief The probability (0.0 to 1.0) for any tile to contain a cell after randomization.
+     */
+    float Density = 0.5f;
+    /**
+     * @brief The seed of the simulator random number generator.
+     */
+    uint32_t Seed = 5489u;
+    /**
+     * @brief The number of simulation steps to run.
+     */
+    uint64_t Ticks = 1000;
+    /**
+     * @brief How the commands of a tick are executed.
+     */
+    Core::EExecutionMode ExecutionMode = Core::EExecutionMode::Serial;
+    /**
+     * @brief Whether the grid ends at its size or extends without limit.
+     */
+    Core::EWorldTopology Topology = Core::EWorldTopology::Bounded;
+    /**
+     * @brief The side length of the square colony randomized in the middle of the grid, or 0 to randomize the whole grid.
+     */
+    int32_t ColonySize = 0;
+    /**
+     * @brief The number of ticks between cell store compactions, or 0 to never compact.
+     */
+    uint64_t CompactionInterval = 0;
+    /**
+     * @brief The share of live cells out of store order that triggers a compaction, or 0 to never compact for it.
+     */
+    float CompactionThreshold = 0.25f;
+    /**
+     * @brief The snapshot to start from instead of a randomized world, or empty to randomize.
+     */
+    std::string LoadPath;
+    /**
+     * @brief The snapshot file written at the end of the run and at every checkpoint, or empty to never save.
+     */
+    std::string SavePath;
+    /**
+     * @brief The number of ticks between checkpoints written to SavePath, or 0 to save only at the end.
+     */
+    uint64_t CheckpointInterval = 0;
+    /**
+     * @brief The Chrome trace file written with the tick profile at the end of the run, or empty to skip it.
+     */
+    std::string TracePath;
+    /**
+     * @brief The CSV file written with the tick profile at the end of the run, or empty to skip it.
+     */
+    std::string ProfileCsvPath;
+    /**
+     * @brief The CSV file the genotype census is written to, or empty to skip it.
+     */
+    std::string CensusCsvPath;
+    /**
+     * @brief The number of ticks between genotype censuses, or 0 to take one only at the end.
+     */
+    uint64_t CensusInterval = 0;
+    /**
+     * @brief The number of most common genotypes written per census, or 0 to write all of them.
+     */
+    size_t CensusTopCount = 0;
+    /**
+     * @brief The binary file the lineage of the genotypes is recorded to, or empty to skip it.
+     */
+    std::string LineagePath;
+    /**
+     * @brief The number of extinct ancestors the lineage recording keeps in memory for pruning.
+     */
+    size_t LineageRetainedAncestors = Core::Simulator::DefaultRetainedAncestors;
+    /**
+     * @brief The CSV file the statistics of every tick are streamed to, or empty to skip it.
+     */
+    std::string StatisticsCsvPath;
+};
+
+/**
+ * @class BatchRunner
+ * @brief Runs the simulation core without any rendering and reports its throughput.
+ */
+class BatchRunner
+{
+public:
+    explicit BatchRunner(const BatchConfig& InConfig);
+
+    /**
+     * @brief Parses command line arguments into a run configuration.
+     * @param Argc The number of arguments.
+     * @param Argv The argument values.
+     * @param OutError Receives a description of the problem if parsing fails.
+     * @return The parsed configuration, or std::nullopt if the arguments are invalid or help was requested.
+     */
+    static std::optional<BatchConfig> ParseCommandLine(int Argc, char** Argv, std::string& OutError);
+
+    /**
+     * @brief Gets the command line usage text.
+     * @param ProgramName The name of the executable.
+     * @return The usage text.
+     */
+    static std::string GetUsage(const std::string& ProgramName);
+
+    /**
+     * @brief Randomizes the world or loads the snapshot and runs the configured number of ticks.
+     * @return The process exit code.
+     */
+    int Run();
+
+private:
+    BatchConfig Config;
+};
+
+} // namespace Headless
+} // namespace CellularSimulator
@@ -1,7 +1,10 @@
 #include "CellularSimulator/App/Application.h"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include "CellularSimulator/Core/GridTile.h"
 #include "CellularSimulator/Core/Cell.h"
@@ -9,10 +12,14 @@
 #include <thread>
 #include "raylib.h"
 #include "raymath.h"
-#include "CellularSimulator/Core/StringInterner.h"
 
 using namespace CellularSimulator::App;
 
+namespace
+{
+constexpr CellularSimulator::Core::CellColor EmptyTileColor = {255, 255, 255, 255};
+} // namespace
+
 Application::Application()
 {
     InitWindow(WindowWidth, WindowHeight, "Cellular Simulator");
@@ -21,6 +28,7 @@ Application::Application()
     int32_t SimHeight = 300;
     Sim = std::make_unique<Core::Simulator>(300, 300);
     Sim->Randomize(0.5f);
+    Sim->SetDirtyTracking(true);
 
     const float WorldWidthPx = static_cast<float>(SimWidth * TileSize);
     const float WorldHeightPx = static_cast<float>(SimHeight * TileSize);
@@ -35,8 +43,6 @@ Application::Application()
     WorldCamera.zoom = InitialZoom;
     WorldCamera.target = {WorldWidthPx / 2.0f, WorldHeightPx / 2.0f};
 
-    Core::StringInterner::GetInstance().InitializeGeneColors();
-
     bIsRunning = true;
     UpdateThread = std::thread(&Application::UpdateLoop, this);
 };
@@ -48,6 +54,10 @@ Application::~Application()
     {
         UpdateThread.join();
     }
+    if (WorldTexture.id != 0)
+    {
+        UnloadTexture(WorldTexture);
+    }
     CloseWindow();
 }
 
@@ -58,13 +68,22 @@ void Application::Run()
 
 void Application::UpdateLoop()
 {
-    auto LastTime = std::chrono::high_resolution_clock::now();
+    auto LastTime = std::chrono::steady_clock::now();
     double TimeAccumulator = 0.0;
+    // Until the render thread publishes its view, the whole world is extracted.
+    ViewRegion View;
+    View.MaxX = Sim->GetWidth();
+    View.MaxY = Sim->GetHeight();
+    // The render thread has nothing to show until the first state is published.
+    bool bStateChanged = true;
+    // The pixels are kept up to date here, so only tiles that changed since the previous tick have to be recomputed.
+    // Publication copies only the rows the write buffer of the triple buffer is missing.
+    SimulationState CurrentState;
+    bool bRebuildPixels = true;
+    std::vector<Core::TilePosition> DirtyTiles;
 
     while (bIsRunning.load())
     {
-        auto FrameStartTime = std::chrono::high_resolution_clock::now();
-
         // Input from main thread
         if (bInputUpdated.load())
         {
@@ -75,77 +94,181 @@ void Application::UpdateLoop()
             }
             bInputUpdated.store(false);
             const Core::GridTile* Tile = Sim->GetTile(InspectingAt.first, InspectingAt.second);
-            if (Tile)
+            const Core::Cell Cell = Tile ? Sim->GetCell(Tile->GetCellId()) : Core::Cell();
+            if (Cell.IsValid())
             {
-                const Core::Cell* Cell = Tile->GetCell();
-                if (Cell)
-                {
-                    SimState.Inspector.Genome = Core::StringInterner::GetInstance().ResolveGenome(Cell->GetGenome());
-                    SimState.Inspector.bShouldDisplayGenome = true;
-                }
+                Inspector.Genome = Core::CommandManager::ResolveGenome(Cell.GetGenome());
+                Inspector.bShouldDisplayGenome = true;
             }
             else
             {
-                SimState.Inspector.bShouldDisplayGenome = false;
+                // An empty tile must not keep showing the genome of the cell inspected before.
+                Inspector.Genome.clear();
+                Inspector.bShouldDisplayGenome = false;
             }
+            bStateChanged = true;
         }
 
-        auto CurrentTime = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> DeltaTime = CurrentTime - LastTime;
+        // The profiler is owned by the update thread, so dumps requested by the render thread are written here.
+        if (bProfileDumpRequested.exchange(false))
+        {
+            const Core::TickProfiler& Profiler = Sim->GetProfiler();
+            if (!Core::TickProfiler::IsEnabled())
+            {
+                std::cerr << "Tick profiling is not compiled in, reconfigure with -DCELLULAR_SIMULATOR_ENABLE_PROFILING=ON\n";
+            }
+            else if (Profiler.WriteChromeTrace("TickProfile.json") && Profiler.WriteCsv("TickProfile.csv"))
+            {
+                std::cout << "Wrote " << Profiler.GetRecordCount() << " ticks to TickProfile.json and TickProfile.csv\n";
+            }
+        }
+
+        const auto CurrentTime = std::chrono::steady_clock::now();
+        const std::chrono::duration<double> DeltaTime = CurrentTime - LastTime;
         LastTime = CurrentTime;
-        if (!bIsPaused.load())
+        const int32_t TargetUpdatesPerSecond = UpdatesPerSecond.load();
+        const double TimeBetweenUpdates = TargetUpdatesPerSecond > 0 ? 1.0 / TargetUpdatesPerSecond : std::numeric_limits<double>::infinity();
+        const double FrameTime = 1.0 / FramesPerSecond;
+        const bool bRunningTicks = TicksToRun.load() > 0;
+        const bool bRunAsFastAsPossible = bRunningTicks || (bFastForward.load() && !bIsPaused.load());
+        if (bRunAsFastAsPossible)
+        {
+            // Ticks run back to back for one frame, then the state is published as usual.
+            const auto FrameEnd = CurrentTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(FrameTime));
+            do
+            {
+                // The render thread may cancel the run at any time, so a tick is claimed before it runs
+                // and the counter never goes below zero.
+                uint64_t Remaining = 0;
+                if (bRunningTicks)
+                {
+                    Remaining = TicksToRun.load();
+                    while (Remaining > 0 && !TicksToRun.compare_exchange_weak(Remaining, Remaining - 1))
+                    {
+                    }
+                    if (Remaining == 0) break;
+                }
+                Sim->Update();
+                bStateChanged = true;
+                if (Remaining == 1)
+                {
+                    bIsPaused = true;
+                    break;
+                }
+            } while (std::chrono::steady_clock::now() < FrameEnd && bIsRunning.load());
+            TimeAccumulator = 0.0;
+        }
+        else if (!bIsPaused.load() && TargetUpdatesPerSecond > 0)
         {
             TimeAccumulator += DeltaTime.count();
-            const double TimeBetweenUpdates = 1.0 / UpdatesPerSecond.load();
             while (TimeAccumulator >= TimeBetweenUpdates)
             {
                 Sim->Update();
                 TimeAccumulator -= TimeBetweenUpdates;
+                bStateChanged = true;
             }
         }
         else
         {
-            TimeAccumulator = 0.f;
+            TimeAccumulator = 0.0;
         }
 
-        SimState.Tiles.clear();
-        SimState.Tiles.reserve(Sim->GetActiveCellCount());
-        for (int32_t i = 0; i < Sim->GetWidth(); ++i)
+        if (ViewBuffers.Acquire())
         {
-            for (int32_t j = 0; j < Sim->GetHeight(); ++j)
-            {
-                const Core::GridTile* TileInProcess = Sim->GetTile(i, j);
-                if (TileInProcess)
-                {
-                    SimState.Tiles.push_back({i, j, GetTileColor(TileInProcess)});
-                }
-            }
+            View = ViewBuffers.GetReadBuffer();
+            bRebuildPixels = true;
+            bStateChanged = true;
         }
-        if (UpdatesPerSecond < FramesPerSecond)
+
+        // A full rebuild is only needed for a new view or a reset world, otherwise the changed tiles are patched.
+        const bool bAllTilesDirty = Sim->TakeDirtyTiles(DirtyTiles);
+        if (bAllTilesDirty || bRebuildPixels || DirtyTiles.size() > CurrentState.Pixels.size())
         {
-            std::lock_guard<std::mutex> Lock(SharedStateMutex);
-            SharedState.UpdateFromBuffer(SimState);
+            BuildRenderPixels(*Sim, View, CurrentState);
+            bRebuildPixels = false;
         }
-        else
+        else if (!DirtyTiles.empty())
         {
-            if (SharedStateMutex.try_lock())
-            {
-                SharedState.UpdateFromBuffer(SimState);
-                SharedStateMutex.unlock();
-            }
+            PatchRenderPixels(*Sim, DirtyTiles, CurrentState);
+        }
+
+        // Render data is only published when the world, the view or the inspector actually changed.
+        if (bStateChanged)
+        {
+            CurrentState.Tick = Sim->GetTickCount();
+            CurrentState.Inspector = Inspector;
+            ++CurrentState.Generation;
+            PublishRenderState(CurrentState);
+            CurrentState.bFullUpload = false;
+            CurrentState.DirtyRowBegin = 0;
+            CurrentState.DirtyRowEnd = 0;
+            bStateChanged = false;
+        }
+
+        // Sleep until the next tick is due, but wake up at least once per frame to pick up input.
+        const double SleepTime = std::min(FrameTime, TimeBetweenUpdates - TimeAccumulator);
+        if (!bRunAsFastAsPossible && SleepTime > 0.0)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double>(SleepTime));
         }
     }
 }
 
+void Application::PublishRenderState(SimulationState& State)
+{
+    // Every row remembers the generation that last changed it, so a write buffer only receives the rows changed
+    // since the generation it holds. The pixel layout only changes on a full rebuild.
+    if (State.bFullUpload)
+    {
+        LayoutGeneration = State.Generation;
+        RowGenerations.assign(State.Height, State.Generation);
+    }
+    else
+    {
+        std::fill(RowGenerations.begin() + State.DirtyRowBegin, RowGenerations.begin() + State.DirtyRowEnd, State.Generation);
+    }
+
+    SimulationState& Target = RenderBuffers.GetWriteBuffer();
+    const uint64_t TargetGeneration = Target.Generation;
+    if (TargetGeneration < LayoutGeneration)
+    {
+        Target = State;
+        RenderBuffers.Publish();
+        return;
+    }
+
+    // Everything but the pixels is small and copied as a whole, the pixels of the target are patched in place.
+    std::vector<Core::CellColor> TargetPixels = std::move(Target.Pixels);
+    std::vector<Core::CellColor> StatePixels = std::move(State.Pixels);
+    Target = State;
+    State.Pixels = std::move(StatePixels);
+    Target.Pixels = std::move(TargetPixels);
+    const size_t RowLength = static_cast<size_t>(State.Width);
+    for (int32_t Row = 0; Row < State.Height;)
+    {
+        if (RowGenerations[Row] <= TargetGeneration)
+        {
+            ++Row;
+            continue;
+        }
+        const int32_t RunBegin = Row;
+        while (Row < State.Height && RowGenerations[Row] > TargetGeneration) ++Row;
+        std::copy(State.Pixels.begin() + RunBegin * RowLength, State.Pixels.begin() + Row * RowLength, Target.Pixels.begin() + RunBegin * RowLength);
+    }
+    RenderBuffers.Publish();
+}
+
 void Application::RenderLoop()
 {
     while (!WindowShouldClose())
     {
+        // Never blocks: either a newer state was published or the previous one is drawn again.
+        if (RenderBuffers.Acquire())
         {
-            std::lock_guard<std::mutex> lock(SharedStateMutex);
-            RenderState = SharedState;
+            UploadWorldTexture();
         }
         ProcessInput();
+        PublishView();
         Draw();
     }
 }
@@ -161,6 +284,24 @@ void Application::ProcessInput()
     if (IsKeyPressed(KEY_SPACE))
     {
         bIsPaused = !bIsPaused;
+        TicksToRun = 0;
+    }
+    // Fast-forward: ticks run back to back instead of at the configured rate
+    if (IsKeyPressed(KEY_F))
+    {
+        bFastForward = !bFastForward;
+    }
+    // Run a fixed number of ticks as fast as possible, then pause
+    if (IsKeyPressed(KEY_N))
+    {
+        TicksToRun = TicksPerRun;
+    }
+    if (IsKeyPressed(KEY_UP)) TicksPerRun = std::min<uint64_t>(TicksPerRun * 10, 100000000);
+    if (IsKeyPressed(KEY_DOWN)) TicksPerRun = std::max<uint64_t>(TicksPerRun / 10, 1);
+    // Tick profile dump
+    if (IsKeyPressed(KEY_P))
+    {
+        bProfileDumpRequested = true;
     }
     // Simulation speed
     if (IsKeyPressed(KEY_RIGHT)) UpdatesPerSecond += 5;
@@ -180,9 +321,10 @@ void Application::ProcessInput()
         Vector2 MouseWorldPos = GetScreenToWorld2D(GetMousePosition(), WorldCamera);
         WorldCamera.offset = GetMousePosition();
         WorldCamera.target = MouseWorldPos;
-        const float ZoomIncrement = 0.125f;
-        WorldCamera.zoom += (WheelMove * ZoomIncrement);
-        if (WorldCamera.zoom < ZoomIncrement) WorldCamera.zoom = ZoomIncrement;
+        // Zoom geometrically so that large worlds can be zoomed out until many tiles share a pixel.
+        const float ZoomFactor = 1.125f;
+        const float MinZoom = 1.0f / (TileSize * 256.0f);
+        WorldCamera.zoom = std::max(MinZoom, WorldCamera.zoom * std::pow(ZoomFactor, WheelMove));
     }
     if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT))
     {
@@ -203,49 +345,155 @@ void Application::Draw()
     BeginDrawing();
     ClearBackground(DARKGRAY);
     BeginMode2D(WorldCamera);
-    for (const auto& TileData : RenderState.Tiles)
+    const SimulationState& RenderState = RenderBuffers.GetReadBuffer();
+    if (WorldTexture.id != 0 && !RenderState.Pixels.empty())
     {
-        DrawRectangle(TileData.X * TileSize, TileData.Y * TileSize, TileSize, TileSize, TileData.TileColor);
+        // One texel per Step x Step block of tiles, stretched over the covered part of the world.
+        const Rectangle Source = {0.0f, 0.0f, static_cast<float>(RenderState.Width), static_cast<float>(RenderState.Height)};
+        const Rectangle Destination = {static_cast<float>(RenderState.OriginX * TileSize), static_cast<float>(RenderState.OriginY * TileSize),
+            static_cast<float>(RenderState.RegionWidth * TileSize), static_cast<float>(RenderState.RegionHeight * TileSize)};
+        DrawTexturePro(WorldTexture, Source, Destination, {0.0f, 0.0f}, 0.0f, WHITE);
     }
     EndMode2D();
-    if (RenderState.Inspector.bShouldDisplayGenome)
+    const InspectorData& RenderInspector = RenderState.Inspector;
+    if (RenderInspector.bShouldDisplayGenome)
     {
-        for (size_t i = 0; i < RenderState.Inspector.Genome.size(); ++i)
+        for (size_t i = 0; i < RenderInspector.Genome.size(); ++i)
         {
-            DrawText(RenderState.Inspector.Genome[i].c_str(), 10, 30 + (i * 20), 20, LIME);
+            DrawText(RenderInspector.Genome[i].c_str(), 10, 30 + (i * 20), 20, LIME);
         }
     }
-    std::string StatusText = bIsPaused.load() ? "PAUSED" : "RUNNING";
-    StatusText += " | UPS: " + std::to_string(UpdatesPerSecond.load());
+    const uint64_t RemainingTicks = TicksToRun.load();
+    std::string StatusText = RemainingTicks > 0 ? "RUNNING " + std::to_string(RemainingTicks) + " TICKS" : bIsPaused.load() ? "PAUSED" : "RUNNING";
+    StatusText += bFastForward.load() ? " | UPS: MAX" : " | UPS: " + std::to_string(UpdatesPerSecond.load());
+    StatusText += " | TICK: " + std::to_string(RenderState.Tick) + " | N: " + std::to_string(TicksPerRun);
     DrawText(StatusText.c_str(), 10, 10, 20, LIME);
     DrawFPS(WindowWidth - 100, 10);
     EndDrawing();
 }
 
-Color Application::GetTileColor(const Core::GridTile* Tile)
+void Application::PublishView()
+{
+    const Vector2 TopLeft = GetScreenToWorld2D({0.0f, 0.0f}, WorldCamera);
+    const Vector2 BottomRight = GetScreenToWorld2D({static_cast<float>(GetScreenWidth()), static_cast<float>(GetScreenHeight())}, WorldCamera);
+    ViewRegion View;
+    View.MinX = static_cast<int32_t>(std::floor(TopLeft.x / TileSize));
+    View.MinY = static_cast<int32_t>(std::floor(TopLeft.y / TileSize));
+    View.MaxX = static_cast<int32_t>(std::ceil(BottomRight.x / TileSize));
+    View.MaxY = static_cast<int32_t>(std::ceil(BottomRight.y / TileSize));
+    const float TilesPerPixel = 1.0f / (WorldCamera.zoom * TileSize);
+    View.Step = std::max(1, static_cast<int32_t>(TilesPerPixel));
+    if (View == PublishedView) return;
+
+    PublishedView = View;
+    ViewBuffers.GetWriteBuffer() = View;
+    ViewBuffers.Publish();
+}
+
+void Application::BuildRenderPixels(Core::Simulator& InSim, const ViewRegion& View, SimulationState& OutState)
+{
+    // Blocks are aligned to multiples of the step, so panning does not change how tiles are grouped.
+    const int32_t Step = std::max(1, View.Step);
+    OutState.Step = Step;
+    auto AlignDown = [Step](int32_t Value) { return (Value >= 0 ? Value / Step : (Value + 1) / Step - 1) * Step; };
+    if (InSim.GetTopology() != Core::EWorldTopology::Unbounded)
+    {
+        OutState.OriginX = AlignDown(std::max(0, View.MinX));
+        OutState.OriginY = AlignDown(std::max(0, View.MinY));
+        OutState.RegionWidth = std::max(0, std::min(InSim.GetWidth(), View.MaxX) - OutState.OriginX);
+        OutState.RegionHeight = std::max(0, std::min(InSim.GetHeight(), View.MaxY) - OutState.OriginY);
+    }
+    else
+    {
+        OutState.OriginX = AlignDown(View.MinX);
+        OutState.OriginY = AlignDown(View.MinY);
+        OutState.RegionWidth = std::max(0, View.MaxX - OutState.OriginX);
+        OutState.RegionHeight = std::max(0, View.MaxY - OutState.OriginY);
+    }
+    OutState.Width = (OutState.RegionWidth + Step - 1) / Step;
+    OutState.Height = (OutState.RegionHeight + Step - 1) / Step;
+    OutState.Pixels.resize(static_cast<size_t>(OutState.Width) * OutState.Height);
+    OutState.bFullUpload = true;
+    OutState.DirtyRowBegin = 0;
+    OutState.DirtyRowEnd = OutState.Height;
+    if (OutState.Pixels.empty()) return;
+    // Colors are cached per cell when genomes change, so extraction is a copy (or block average) of the visible tiles.
+    InSim.CopyRegionColors(OutState.OriginX, OutState.OriginY, OutState.RegionWidth, OutState.RegionHeight, Step, OutState.Pixels.data(),
+        EmptyTileColor);
+}
+
+void Application::PatchRenderPixels(Core::Simulator& InSim, const std::vector<Core::TilePosition>& Tiles, SimulationState& InOutState)
+{
+    const int32_t Step = InOutState.Step;
+    size_t LastPixel = std::numeric_limits<size_t>::max();
+    for (const Core::TilePosition& Tile : Tiles)
+    {
+        const int32_t LocalX = Tile.X - InOutState.OriginX;
+        const int32_t LocalY = Tile.Y - InOutState.OriginY;
+        if (LocalX < 0 || LocalX >= InOutState.RegionWidth || LocalY < 0 || LocalY >= InOutState.RegionHeight) continue;
+
+        const int32_t PixelX = LocalX / Step;
+        const int32_t PixelY = LocalY / Step;
+        const size_t Pixel = static_cast<size_t>(PixelY) * InOutState.Width + PixelX;
+        // Tiles come chunk by chunk in row order, so neighbouring dirty tiles of one block come in a row and the block is averaged once.
+        if (Pixel == LastPixel) continue;
+        LastPixel = Pixel;
+
+        const int32_t FirstX = InOutState.OriginX + PixelX * Step;
+        const int32_t FirstY = InOutState.OriginY + PixelY * Step;
+        const int32_t BlockWidth = std::min(Step, InOutState.OriginX + InOutState.RegionWidth - FirstX);
+        const int32_t BlockHeight = std::min(Step, InOutState.OriginY + InOutState.RegionHeight - FirstY);
+        InOutState.Pixels[Pixel] = InSim.GetRegionColor(FirstX, FirstY, BlockWidth, BlockHeight, EmptyTileColor);
+
+        if (InOutState.DirtyRowBegin == InOutState.DirtyRowEnd)
+        {
+            InOutState.DirtyRowBegin = PixelY;
+            InOutState.DirtyRowEnd = PixelY + 1;
+        }
+        else
+        {
+            InOutState.DirtyRowBegin = std::min(InOutState.DirtyRowBegin, PixelY);
+            InOutState.DirtyRowEnd = std::max(InOutState.DirtyRowEnd, PixelY + 1);
+        }
+    }
+}
+
+void Application::UploadWorldTexture()
 {
-    if (!Tile) return BLACK;
-    return GetCellColor(Tile->GetCell());
+    const SimulationState& RenderState = RenderBuffers.GetReadBuffer();
+    // A state that directly follows the uploaded one only needs its changed rows, anything else is uploaded whole.
+    const bool bFullUpload = RenderState.bFullUpload || RenderState.Generation != UploadedGeneration + 1;
+    UploadedGeneration = RenderState.Generation;
+    if (RenderState.Pixels.empty()) return;
+    // The texture only grows, the visible part is uploaded into its top-left corner.
+    if (WorldTexture.width < RenderState.Width || WorldTexture.height < RenderState.Height)
+    {
+        const int32_t TextureWidth = std::max(WorldTexture.width, RenderState.Width);
+        const int32_t TextureHeight = std::max(WorldTexture.height, RenderState.Height);
+        if (WorldTexture.id != 0)
+        {
+            UnloadTexture(WorldTexture);
+        }
+        Image WorldImage = GenImageColor(TextureWidth, TextureHeight, BLANK);
+        WorldTexture = LoadTextureFromImage(WorldImage);
+        UnloadImage(WorldImage);
+        SetTextureFilter(WorldTexture, TEXTURE_FILTER_POINT);
+    }
+    else if (!bFullUpload)
+    {
+        if (RenderState.DirtyRowBegin >= RenderState.DirtyRowEnd) return;
+        const Rectangle Rows = {0.0f, static_cast<float>(RenderState.DirtyRowBegin), static_cast<float>(RenderState.Width),
+            static_cast<float>(RenderState.DirtyRowEnd - RenderState.DirtyRowBegin)};
+        UpdateTextureRec(WorldTexture, Rows, RenderState.Pixels.data() + static_cast<size_t>(RenderState.DirtyRowBegin) * RenderState.Width);
+        return;
+    }
+    const Rectangle Region = {0.0f, 0.0f, static_cast<float>(RenderState.Width), static_cast<float>(RenderState.Height)};
+    UpdateTextureRec(WorldTexture, Region, RenderState.Pixels.data());
 }
 
-Color Application::GetCellColor(const Core::Cell* InCell)
+Color Application::GetCellColor(const Core::Cell& InCell)
 {
-    if (!InCell) return WHITE;
-    std::vector<size_t> Genome = InCell->GetGenome();
-    const size_t GenomeSize = Genome.size();
-    if (GenomeSize == 0) return DARKGRAY;
-    float TotalR = 0, TotalG = 0, TotalB = 0;
-    for (size_t i = 0; i < GenomeSize; ++i)
-    {
-        size_t GeneHash = Genome[i];
-        float Weight = 1.0f - (static_cast<float>(i) / GenomeSize);
-        Color GeneColor = Core::StringInterner::GetInstance().GetGeneColor(GeneHash);
-        TotalR += GeneColor.r * Weight;
-        TotalG += GeneColor.g * Weight;
-        TotalB += GeneColor.b * Weight;
-    }
-    unsigned char FinalR = static_cast<unsigned char>(TotalR / GenomeSize);
-    unsigned char FinalG = static_cast<unsigned char>(TotalG / GenomeSize);
-    unsigned char FinalB = static_cast<unsigned char>(TotalB / GenomeSize);
-    return {FinalR, FinalG, FinalB, 255};
-}
\ No newline at end of file
+    if (!InCell.IsValid()) return WHITE;
+    const Core::CellColor CachedColor = InCell.GetColor();
+    return {CachedColor.R, CachedColor.G, CachedColor.B, CachedColor.A};
+}
@@ -0,0 +1,52 @@
+#include "CellularSimulator/Benchmark/AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<uint64_t> AllocationCount{0};
+
+void* CountedAllocate(std::size_t Size)
+{
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* Memory = std::malloc(Size == 0 ? 1 : Size)) return Memory;
+    throw std::bad_alloc();
+}
+} // namespace
+
+uint64_t CellularSimulator::Benchmark::GetAllocationCount()
+{
+    return AllocationCount.load(std::memory_order_relaxed);
+}
+
+// Replacements of the global allocation functions. Over-aligned allocations keep the default implementation.
+void* operator new(std::size_t Size)
+{
+    return CountedAllocate(Size);
+}
+
+void* operator new[](std::size_t Size)
+{
+    return CountedAllocate(Size);
+}
+
+void operator delete(void* Memory) noexcept
+{
+    std::free(Memory);
+}
+
+void operator delete[](void* Memory) noexcept
+{
+    std::free(Memory);
+}
+
+void operator delete(void* Memory, std::size_t) noexcept
+{
+    std::free(Memory);
+}
+
+void operator delete[](void* Memory, std::size_t) noexcept
+{
+    std::free(Memory);
+}
@@ -0,0 +1,338 @@
+#include "CellularSimulator/Benchmark/BenchmarkSuite.h"
+#include <charconv>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+#include "CellularSimulator/Benchmark/AllocationCounter.h"
+#include "CellularSimulator/Core/Command.h"
+#include "CellularSimulator/Core/CommandManager.h"
+#include "CellularSimulator/Core/Simulator.h"
+#include "CellularSimulator/Core/StringInterner.h"
+#ifdef CELLULAR_SIMULATOR_BENCHMARK_APP
+#include "CellularSimulator/App/Application.h"
+#endif
+
+using namespace CellularSimulator::Benchmark;
+using namespace CellularSimulator;
+
+namespace
+{
+template <typename TValue>
+bool ParseInteger(std::string_view Text, TValue& OutValue)
+{
+    const char* End = Text.data() + Text.size();
+    auto [Ptr, Error] = std::from_chars(Text.data(), End, OutValue);
+    return Error == std::errc() && Ptr == End;
+}
+
+std::string FormatDensity(float Density)
+{
+    std::ostringstream Stream;
+    Stream << std::fixed << std::setprecision(1) << Density;
+    return Stream.str();
+}
+
+/**
+ * Collects the ids of the live cells, so that a benchmark can visit them without the list changing under it.
+ */
+std::vector<Core::CellId> CollectActiveIds(Core::Simulator& Sim)
+{
+    std::vector<Core::CellId> Ids(Sim.GetActiveCellCount());
+    for (size_t i = 0; i < Ids.size(); ++i)
+    {
+        Ids[i] = Sim.GetActiveCellByIndex(i).GetId();
+    }
+    return Ids;
+}
+
+/**
+ * Results of the measured loops are stored here so that the compiler cannot drop the loops.
+ */
+volatile uint64_t Sink = 0;
+
+constexpr int32_t UpdateSizes[] = {128, 512, 1024};
+constexpr float UpdateDensities[] = {0.1f, 0.5f, 0.9f};
+constexpr int32_t WorkloadSize = 256;
+constexpr float WorkloadDensity = 0.5f;
+} // namespace
+
+BenchmarkSuite::BenchmarkSuite(const BenchmarkConfig& InConfig) : Config(InConfig)
+{
+}
+
+std::optional<BenchmarkConfig> BenchmarkSuite::ParseCommandLine(int Argc, char** Argv, std::string& OutError)
+{
+    BenchmarkConfig Result;
+    for (int i = 1; i < Argc; ++i)
+    {
+        const std::string Option = Argv[i];
+        if (Option == "--help" || Option == "-h")
+        {
+            OutError.clear();
+            return std::nullopt;
+        }
+        if (i + 1 >= Argc)
+        {
+            OutError = "Missing value for option '" + Option + "'";
+            return std::nullopt;
+        }
+        const std::string Value = Argv[++i];
+
+        bool bParsed = false;
+        if (Option == "--filter")
+        {
+            Result.Filter = Value;
+            bParsed = true;
+        }
+        else if (Option == "--ticks")
+        {
+            bParsed = ParseInteger(Value, Result.Ticks) && Result.Ticks > 0;
+        }
+        else if (Option == "--repetitions")
+        {
+            bParsed = ParseInteger(Value, Result.Repetitions) && Result.Repetitions > 0;
+        }
+        else
+        {
+            OutError = "Unknown option '" + Option + "'";
+            return std::nullopt;
+        }
+
+        if (!bParsed)
+        {
+            OutError = "Invalid value '" + Value + "' for option '" + Option + "'";
+            return std::nullopt;
+        }
+    }
+    return Result;
+}
+
+std::string BenchmarkSuite::GetUsage(const std::string& ProgramName)
+{
+    std::ostringstream Usage;
+    Usage << "Usage: " << ProgramName << " [options]\n"
+          << "  --filter <text>         Run only benchmarks whose name contains the text\n"
+          << "  --ticks <uint>          Ticks measured by every update benchmark (default 20)\n"
+          << "  --repetitions <uint>    Repetitions of every other benchmark (default 5)\n"
+          << "  --help                  Show this message\n";
+    return Usage.str();
+}
+
+int BenchmarkSuite::Run()
+{
+    std::cout << std::left << std::setw(44) << "Benchmark" << std::right << std::setw(14) << "ns/item" << "  " << std::left
+              << std::setw(12) << "item" << std::right << std::setw(14) << "allocs/iter" << "  " << std::left << "iter\n";
+
+    RunUpdateBenchmarks();
+    RunRandomizeBenchmarks();
+    RunCommandBenchmarks();
+    RunStringInternerBenchmarks();
+    RunApplicationBenchmarks();
+
+    if (Results.empty())
+    {
+        std::cerr << "No benchmark matches the filter '" << Config.Filter << "'\n";
+        return 1;
+    }
+    return 0;
+}
+
+bool BenchmarkSuite::IsSelected(const std::string& Name) const
+{
+    return Config.Filter.empty() || Name.find(Config.Filter) != std::string::npos;
+}
+
+void BenchmarkSuite::Measure(const std::string& Name, const std::string& Unit, const std::string& Iteration, uint64_t Iterations,
+    const std::function<void()>& Setup, const BenchmarkBody& Body)
+{
+    if (!IsSelected(Name)) return;
+
+    double Seconds = 0.0;
+    uint64_t Items = 0;
+    uint64_t Allocations = 0;
+    for (uint64_t Repetition = 0; Repetition < Iterations; ++Repetition)
+    {
+        if (Setup) Setup();
+        const uint64_t AllocationsBefore = GetAllocationCount();
+        const auto StartTime = std::chrono::steady_clock::now();
+        Items += Body();
+        const auto EndTime = std::chrono::steady_clock::now();
+        Allocations += GetAllocationCount() - AllocationsBefore;
+        Seconds += std::chrono::duration<double>(EndTime - StartTime).count();
+    }
+
+    BenchmarkResult Result;
+    Result.Name = Name;
+    Result.Unit = Unit;
+    Result.NsPerItem = Items > 0 ? Seconds * 1e9 / static_cast<double>(Items) : 0.0;
+    Result.Iteration = Iteration;
+    Result.AllocationsPerIteration = static_cast<double>(Allocations) / static_cast<double>(Iterations);
+
+    std::cout << std::left << std::setw(44) << Result.Name << std::right << std::fixed << std::setprecision(2) << std::setw(14)
+              << Result.NsPerItem << "  " << std::left << std::setw(12) << Result.Unit << std::right << std::setw(14)
+              << Result.AllocationsPerIteration << "  " << std::left << Result.Iteration << "\n";
+    Results.push_back(std::move(Result));
+}
+
+void BenchmarkSuite::RunUpdateBenchmarks()
+{
+    for (const Core::EExecutionMode Mode : {Core::EExecutionMode::Serial, Core::EExecutionMode::Parallel})
+    {
+        const char* ModeName = Mode == Core::EExecutionMode::Parallel ? "parallel" : "serial";
+        for (const int32_t Size : UpdateSizes)
+        {
+            for (const float Density : UpdateDensities)
+            {
+                const std::string Name = "Update/" + std::to_string(Size) + "x" + std::to_string(Size) + "/d" + FormatDensity(Density) + "/" + ModeName;
+                if (!IsSelected(Name)) continue;
+
+                // Every tick is one iteration, the world is randomized once and evolves across them.
+                Core::Simulator Sim(Size, Size);
+                Sim.SetExecutionMode(Mode);
+                Sim.Randomize(Density);
+                Measure(Name, "cell*tick", "tick", Config.Ticks, nullptr, [&Sim]() {
+                    const uint64_t Population = Sim.GetActiveCellCount();
+                    Sim.Update();
+                    return Population;
+                });
+            }
+        }
+    }
+}
+
+void BenchmarkSuite::RunRandomizeBenchmarks()
+{
+    for (const int32_t Size : UpdateSizes)
+    {
+        const std::string Name = "Randomize/" + std::to_string(Size) + "x" + std::to_string(Size) + "/d" + FormatDensity(WorkloadDensity);
+        if (!IsSelected(Name)) continue;
+
+        Core::Simulator Sim(Size, Size);
+        Measure(Name, "tile", "call", Config.Repetitions, nullptr, [&Sim, Size]() {
+            Sim.Randomize(WorkloadDensity);
+            return static_cast<uint64_t>(Size) * Size;
+        });
+    }
+}
+
+void BenchmarkSuite::RunCommandBenchmarks()
+{
+    const size_t CommandCount = Core::CommandManager::GetRegisteredCommandCount();
+    for (size_t i = 0; i < CommandCount; ++i)
+    {
+        const Core::Opcode CommandOpcode = static_cast<Core::Opcode>(i);
+        const std::string Name = "Execute/" + std::string(Core::CommandManager::GetCommandName(CommandOpcode));
+        if (!IsSelected(Name)) continue;
+
+        // Every repetition runs the command once for every cell of a freshly randomized world.
+        Core::Command* Cmd = Core::CommandManager::GetCommand(CommandOpcode);
+        Core::Simulator Sim(WorkloadSize, WorkloadSize);
+        std::vector<Core::CellId> Ids;
+        Measure(
+            Name, "call", "pass", Config.Repetitions,
+            [&Sim, &Ids]() {
+                Sim.Randomize(WorkloadDensity);
+                Ids = CollectActiveIds(Sim);
+            },
+            [&Sim, &Ids, Cmd]() {
+                for (const Core::CellId Id : Ids)
+                {
+                    Core::Cell Agent = Sim.GetCell(Id);
+                    if (Agent.IsValid()) Cmd->Execute(Sim, Agent);
+                }
+                return static_cast<uint64_t>(Ids.size());
+            });
+    }
+
+    // The same passes through the batch entry point the parallel execution mode uses.
+    for (size_t i = 0; i < CommandCount; ++i)
+    {
+        const Core::Opcode CommandOpcode = static_cast<Core::Opcode>(i);
+        const std::string Name = "ExecuteBatch/" + std::string(Core::CommandManager::GetCommandName(CommandOpcode));
+        if (!IsSelected(Name)) continue;
+
+        Core::Command* Cmd = Core::CommandManager::GetCommand(CommandOpcode);
+        Core::Simulator Sim(WorkloadSize, WorkloadSize);
+        std::vector<Core::CellId> Ids;
+        Measure(
+            Name, "call", "pass", Config.Repetitions,
+            [&Sim, &Ids]() {
+                Sim.Randomize(WorkloadDensity);
+                Ids = CollectActiveIds(Sim);
+            },
+            [&Sim, &Ids, Cmd]() {
+                Cmd->ExecuteBatch(Sim, {Ids.data(), Ids.size()});
+                return static_cast<uint64_t>(Ids.size());
+            });
+    }
+}
+
+void BenchmarkSuite::RunStringInternerBenchmarks()
+{
+    constexpr size_t StringCount = 1024;
+    std::vector<std::string> Strings(StringCount);
+    for (size_t i = 0; i < StringCount; ++i)
+    {
+        Strings[i] = "BenchmarkGene" + std::to_string(i);
+    }
+    Core::StringInterner& Interner = Core::StringInterner::GetInstance();
+    std::vector<size_t> Hashes(StringCount);
+    for (size_t i = 0; i < StringCount; ++i)
+    {
+        Hashes[i] = Interner.Intern(Strings[i]);
+    }
+
+    // Both benchmarks hit strings that are already interned, as every lookup after startup does.
+    Measure("StringInterner/Intern", "call", "1024 calls", Config.Repetitions, nullptr, [&]() {
+        size_t Checksum = 0;
+        for (const std::string& String : Strings)
+        {
+            Checksum += Interner.Intern(String);
+        }
+        Sink = Checksum;
+        return static_cast<uint64_t>(StringCount);
+    });
+    Measure("StringInterner/Resolve", "call", "1024 calls", Config.Repetitions, nullptr, [&]() {
+        size_t Checksum = 0;
+        for (const size_t Hash : Hashes)
+        {
+            Checksum += Interner.Resolve(Hash).size();
+        }
+        Sink = Checksum;
+        return static_cast<uint64_t>(StringCount);
+    });
+}
+
+void BenchmarkSuite::RunApplicationBenchmarks()
+{
+#ifdef CELLULAR_SIMULATOR_BENCHMARK_APP
+    Core::Simulator Sim(WorkloadSize, WorkloadSize);
+    Sim.Randomize(WorkloadDensity);
+    const std::vector<Core::CellId> Ids = CollectActiveIds(Sim);
+
+    Measure("Application/GetCellColor", "cell", "frame", Config.Repetitions, nullptr, [&Sim, &Ids]() {
+        uint64_t Checksum = 0;
+        for (const Core::CellId Id : Ids)
+        {
+            Checksum += App::Application::GetCellColor(Sim.GetCell(Id)).r;
+        }
+        Sink = Checksum;
+        return static_cast<uint64_t>(Ids.size());
+    });
+
+    App::SimulationState State;
+    for (const int32_t Step : {1, 4})
+    {
+        App::ViewRegion View;
+        View.MaxX = Sim.GetWidth();
+        View.MaxY = Sim.GetHeight();
+        View.Step = Step;
+        Measure("Application/BuildRenderPixels/step" + std::to_string(Step), "tile", "frame", Config.Repetitions, nullptr, [&Sim, &State, View]() {
+            App::Application::BuildRenderPixels(Sim, View, State);
+            return static_cast<uint64_t>(Sim.GetWidth()) * Sim.GetHeight();
+        });
+    }
+#endif
+}
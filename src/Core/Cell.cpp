@@ -1,108 +1,92 @@
-#include <utility>
+#include <algorithm>
 #include "CellularSimulator/Core/Cell.h"
+#include "CellularSimulator/Core/CellStore.h"
 
 using namespace CellularSimulator::Core;
 
-Cell::Cell(int32_t InX, int32_t InY, EDirection InDirection, std::vector<size_t> InGenome, float InEnergy, bool InInObjectPool)
+Cell::Cell(CellStore* InStore, CellId InId) : Store(InStore), Id(InId)
 {
-    Initialize(InX, InY, InDirection, std::move(InGenome), InEnergy, InInObjectPool);
-}
-
-void Cell::Initialize(int32_t InX, int32_t InY, EDirection InDirection, std::vector<size_t> InGenome, float InEnergy, bool InInObjectPool)
-{
-    SetX(InX);
-    SetY(InY);
-    SetDirection(InDirection);
-    SetGenome(std::move(InGenome));
-    SetEnergy(InEnergy);
-    SetInObjectPool(InInObjectPool);
-}
-
-size_t Cell::DecideNextCommand()
-{
-    if (Genome.empty()) return 0;
-    size_t CommandHash = Genome[GenomePointer];
-    GenomePointer++;
-    if (GenomePointer >= Genome.size())
-    {
-        GenomePointer = 0;
-    }
-    return CommandHash;
 }
 
 int32_t Cell::GetX() const
 {
-    return X;
+    return Store->GetX(Id);
 }
 
 int32_t Cell::GetY() const
 {
-    return Y;
+    return Store->GetY(Id);
 }
 
 EDirection Cell::GetDirection() const
 {
-    return Direction;
+    return Store->GetDirection(Id);
 }
 
 float Cell::GetEnergy() const
 {
-    return Energy;
+    return Store->GetEnergy(Id);
 }
 
 bool Cell::IsAlive() const
 {
-    return Energy > 0.0f;
+    return Store->GetEnergy(Id) > 0.0f;
 }
 
-bool Cell::IsInObjectPool() const
+GenomeView Cell::GetGenome() const
 {
-    return bInsideObjectPool;
+    return Store->GetGenome(Id);
 }
 
-const std::vector<size_t>& Cell::GetGenome() const
+GenomeId Cell::GetGenomeId() const
 {
-    return Genome;
+    return Store->GetGenomeId(Id);
+}
+
+CellColor Cell::GetColor() const
+{
+    return Store->GetColor(Id);
 }
 
 void Cell::SetX(int32_t InX)
 {
-    X = InX;
+    Store->SetX(Id, InX);
 }
 
 void Cell::SetY(int32_t InY)
 {
-    Y = InY;
+    Store->SetY(Id, InY);
 }
 
 void Cell::SetDirection(EDirection InDirection)
 {
-    Direction = InDirection;
+    Store->SetDirection(Id, InDirection);
 }
 
 void Cell::AddEnergy(float Amount)
 {
     if (Amount < 0.0f) return;
-    Energy = std::min(MaxEnergy, Energy + Amount);
+    Store->SetEnergy(Id, std::min(CellStore::MaxEnergy, Store->GetEnergy(Id) + Amount));
 }
 
 void Cell::ConsumeEnergy(float Amount)
 {
     if (Amount < 0.0f) return;
-    Energy = std::max(0.0f, Energy - Amount);
+    Store->SetEnergy(Id, std::max(0.0f, Store->GetEnergy(Id) - Amount));
 }
 
 void Cell::SetEnergy(float InEnergy)
 {
-    Energy = std::max(0.0f, std::min(MaxEnergy, InEnergy));
+    Store->SetEnergy(Id, std::max(0.0f, std::min(CellStore::MaxEnergy, InEnergy)));
 }
 
-void Cell::SetGenome(std::vector<size_t> InGenome)
+void Cell::SetGenome(GenomeView InGenome)
 {
-    Genome = std::move(InGenome);
+    Store->SetGenome(Id, InGenome);
 }
 
-void Cell::SetInObjectPool(bool bInObjectPool)
+void Cell::SetGene(size_t Index, Opcode Gene)
 {
-    bInsideObjectPool = bInObjectPool;
-}
\ No newline at end of file
+    if (Index >= Store->GetGenomeLength()) return;
+    Store->SetGene(Id, Index, Gene);
+}
@@ -0,0 +1,205 @@
+#include "CellularSimulator/Core/CellStore.h"
+#include <algorithm>
+#include <utility>
+
+using namespace CellularSimulator::Core;
+
+void CellStore::Resize(size_t Capacity, size_t InGenomeLength)
+{
+    Clear();
+    GenomeLength = InGenomeLength;
+    Genomes.Reset(GenomeLength);
+    X.resize(Capacity);
+    Y.resize(Capacity);
+    Direction.resize(Capacity, EDirection::None);
+    Energy.resize(Capacity, 0.0f);
+    GenomePointer.resize(Capacity, 0);
+    GenomeIds.resize(Capacity, InvalidGenomeId);
+    LiveBits.resize((Capacity + 63) / 64, 0);
+}
+
+void CellStore::EnsureFreeSlots(size_t Count)
+{
+    const size_t FreeCount = GetFreeCount();
+    if (FreeCount >= Count) return;
+    // Geometric growth keeps the cost of a population that keeps growing linear.
+    const size_t Capacity = std::max(GetCapacity() + (Count - FreeCount), GetCapacity() * 2);
+    X.resize(Capacity);
+    Y.resize(Capacity);
+    Direction.resize(Capacity, EDirection::None);
+    Energy.resize(Capacity, 0.0f);
+    GenomePointer.resize(Capacity, 0);
+    GenomeIds.resize(Capacity, InvalidGenomeId);
+    LiveBits.resize((Capacity + 63) / 64, 0);
+}
+
+void CellStore::Clear()
+{
+    std::fill(Energy.begin(), Energy.begin() + SlotCount, 0.0f);
+    std::fill(GenomeIds.begin(), GenomeIds.begin() + SlotCount, InvalidGenomeId);
+    Genomes.Reset(GenomeLength);
+    std::fill(LiveBits.begin(), LiveBits.end(), 0);
+    FreeSlots.clear();
+    SlotCount = 0;
+}
+
+CellId CellStore::Allocate()
+{
+    const CellId Id = PeekAllocation(0);
+    if (Id != InvalidCellId) CommitAllocations(1);
+    return Id;
+}
+
+void CellStore::Free(CellId Id)
+{
+    Energy[Id] = 0.0f;
+    Genomes.Release(GenomeIds[Id]);
+    GenomeIds[Id] = InvalidGenomeId;
+    LiveBits[Id >> 6] &= ~(uint64_t{1} << (Id & 63));
+    FreeSlots.push_back(Id);
+}
+
+CellId CellStore::PeekAllocation(size_t Ticket) const
+{
+    if (Ticket < FreeSlots.size()) return FreeSlots[FreeSlots.size() - 1 - Ticket];
+    const size_t Slot = SlotCount + (Ticket - FreeSlots.size());
+    return Slot < GetCapacity() ? static_cast<CellId>(Slot) : InvalidCellId;
+}
+
+void CellStore::CommitAllocations(size_t Count)
+{
+    for (size_t i = 0; i < Count; ++i)
+    {
+        CellId Id;
+        if (!FreeSlots.empty())
+        {
+            Id = FreeSlots.back();
+            FreeSlots.pop_back();
+        }
+        else
+        {
+            Id = static_cast<CellId>(SlotCount++);
+        }
+        LiveBits[Id >> 6] |= uint64_t{1} << (Id & 63);
+    }
+}
+
+void CellStore::Reorder(const CellId* Order, size_t Count)
+{
+    // Every slot below the high-water mark gets a destination: the listed cells go to [0, Count)
+    // and the remaining slots fill the rest, then the permutation is applied with swaps.
+    ReorderDestination.assign(SlotCount, InvalidCellId);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        ReorderDestination[Order[i]] = static_cast<CellId>(i);
+    }
+    CellId NextUnused = static_cast<CellId>(Count);
+    for (CellId& Destination : ReorderDestination)
+    {
+        if (Destination == InvalidCellId) Destination = NextUnused++;
+    }
+    for (CellId i = 0; i < SlotCount; ++i)
+    {
+        while (ReorderDestination[i] != i)
+        {
+            const CellId j = ReorderDestination[i];
+            Swap(i, j);
+            std::swap(ReorderDestination[i], ReorderDestination[j]);
+        }
+    }
+
+    std::fill(Energy.begin() + Count, Energy.begin() + SlotCount, 0.0f);
+    std::fill(LiveBits.begin(), LiveBits.end(), 0);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        LiveBits[i >> 6] |= uint64_t{1} << (i & 63);
+    }
+    FreeSlots.clear();
+    SlotCount = Count;
+}
+
+void CellStore::RestoreSlots(size_t InSlotCount, const CellId* InFreeSlots, size_t FreeCount)
+{
+    Clear();
+    SlotCount = InSlotCount;
+    for (size_t i = 0; i < SlotCount; ++i)
+    {
+        LiveBits[i >> 6] |= uint64_t{1} << (i & 63);
+    }
+    FreeSlots.assign(InFreeSlots, InFreeSlots + FreeCount);
+    for (CellId Id : FreeSlots)
+    {
+        Energy[Id] = 0.0f;
+        LiveBits[Id >> 6] &= ~(uint64_t{1} << (Id & 63));
+    }
+}
+
+void CellStore::Initialize(CellId Id, int32_t InX, int32_t InY, EDirection InDirection, GenomeView InGenome, float InEnergy)
+{
+    X[Id] = InX;
+    Y[Id] = InY;
+    Direction[Id] = InDirection;
+    Energy[Id] = InEnergy;
+    GenomePointer[Id] = 0;
+    GenomeIds[Id] = InternGenome(InGenome);
+}
+
+void CellStore::Initialize(CellId Id, int32_t InX, int32_t InY, EDirection InDirection, GenomeId InGenome, float InEnergy)
+{
+    X[Id] = InX;
+    Y[Id] = InY;
+    Direction[Id] = InDirection;
+    Energy[Id] = InEnergy;
+    GenomePointer[Id] = 0;
+    Genomes.AddReference(InGenome);
+    GenomeIds[Id] = InGenome;
+}
+
+void CellStore::Swap(CellId A, CellId B)
+{
+    if (A == B) return;
+    std::swap(X[A], X[B]);
+    std::swap(Y[A], Y[B]);
+    std::swap(Direction[A], Direction[B]);
+    std::swap(Energy[A], Energy[B]);
+    std::swap(GenomePointer[A], GenomePointer[B]);
+    std::swap(GenomeIds[A], GenomeIds[B]);
+}
+
+Opcode CellStore::DecideNextCommand(CellId Id)
+{
+    if (GenomeLength == 0) return 0;
+    uint16_t& Pointer = GenomePointer[Id];
+    const Opcode Command = Genomes.GetGenes(GenomeIds[Id])[Pointer];
+    Pointer++;
+    if (Pointer >= GenomeLength)
+    {
+        Pointer = 0;
+    }
+    return Command;
+}
+
+void CellStore::SetGenome(CellId Id, GenomeView InGenome)
+{
+    // The new genome is interned first, so it stays referenced if the view points into the old one.
+    const GenomeId Previous = GenomeIds[Id];
+    GenomeIds[Id] = InternGenome(InGenome);
+    Genomes.Release(Previous);
+}
+
+void CellStore::SetGene(CellId Id, size_t Index, Opcode Gene)
+{
+    const GenomeId Previous = GenomeIds[Id];
+    if (Genomes.GetGenes(Previous)[Index] == Gene) return;
+    GenomeIds[Id] = Genomes.InternEdited(Previous, Index, Gene);
+    Genomes.Release(Previous);
+}
+
+GenomeId CellStore::InternGenome(GenomeView InGenome)
+{
+    if (InGenome.size() == GenomeLength) return Genomes.Intern(InGenome);
+    // Genomes of another length are truncated or padded with opcode 0.
+    std::vector<Opcode> Resized(GenomeLength, Opcode{0});
+    std::copy_n(InGenome.begin(), std::min(GenomeLength, InGenome.size()), Resized.begin());
+    return Genomes.Intern({Resized.data(), Resized.size()});
+}
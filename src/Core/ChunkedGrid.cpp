@@ -0,0 +1,84 @@
+#include "CellularSimulator/Core/ChunkedGrid.h"
+#include <algorithm>
+
+using namespace CellularSimulator::Core;
+
+void ChunkedGrid::Reset(int32_t ChunkCountX, int32_t ChunkCountY)
+{
+    Tiles.clear();
+    Chunks.clear();
+    FreeChunks.clear();
+    DirectoryMinX = 0;
+    DirectoryMinY = 0;
+    DirectoryWidth = std::max(0, ChunkCountX);
+    DirectoryHeight = std::max(0, ChunkCountY);
+    Directory.assign(static_cast<size_t>(DirectoryWidth) * DirectoryHeight, NoChunk);
+}
+
+uint32_t ChunkedGrid::AcquireChunk(int32_t ChunkX, int32_t ChunkY)
+{
+    const uint32_t Existing = FindChunk(ChunkX, ChunkY);
+    if (Existing != NoChunk) return Existing;
+
+    GrowDirectory(ChunkX, ChunkY);
+    uint32_t Slot;
+    if (!FreeChunks.empty())
+    {
+        Slot = FreeChunks.back();
+        FreeChunks.pop_back();
+    }
+    else
+    {
+        Slot = static_cast<uint32_t>(Chunks.size());
+        Chunks.emplace_back();
+        Tiles.resize(Tiles.size() + TilesPerChunk);
+    }
+    Chunks[Slot] = {ChunkX, ChunkY};
+    Directory[static_cast<size_t>(ChunkY - DirectoryMinY) * DirectoryWidth + (ChunkX - DirectoryMinX)] = Slot;
+    return Slot;
+}
+
+void ChunkedGrid::ReleaseChunk(uint32_t Slot)
+{
+    const ChunkInfo& Chunk = Chunks[Slot];
+    Directory[static_cast<size_t>(Chunk.Y - DirectoryMinY) * DirectoryWidth + (Chunk.X - DirectoryMinX)] = NoChunk;
+    FreeChunks.push_back(Slot);
+}
+
+void ChunkedGrid::GrowDirectory(int32_t ChunkX, int32_t ChunkY)
+{
+    int32_t MinX = DirectoryMinX;
+    int32_t MinY = DirectoryMinY;
+    int32_t MaxX = DirectoryMinX + DirectoryWidth;
+    int32_t MaxY = DirectoryMinY + DirectoryHeight;
+    if (Directory.empty())
+    {
+        MinX = ChunkX;
+        MinY = ChunkY;
+        MaxX = ChunkX + 1;
+        MaxY = ChunkY + 1;
+    }
+    if (ChunkX >= MinX && ChunkX < MaxX && ChunkY >= MinY && ChunkY < MaxY && !Directory.empty()) return;
+
+    // The box at least doubles towards the new chunk, so a colony spreading in one direction
+    // only copies the directory a logarithmic number of times.
+    if (ChunkX < MinX) MinX = std::min(ChunkX, MinX - DirectoryWidth);
+    if (ChunkX >= MaxX) MaxX = std::max(ChunkX + 1, MaxX + DirectoryWidth);
+    if (ChunkY < MinY) MinY = std::min(ChunkY, MinY - DirectoryHeight);
+    if (ChunkY >= MaxY) MaxY = std::max(ChunkY + 1, MaxY + DirectoryHeight);
+
+    const int32_t NewWidth = MaxX - MinX;
+    const int32_t NewHeight = MaxY - MinY;
+    std::vector<uint32_t> NewDirectory(static_cast<size_t>(NewWidth) * NewHeight, NoChunk);
+    for (int32_t Row = 0; Row < DirectoryHeight; ++Row)
+    {
+        const auto Source = Directory.begin() + static_cast<ptrdiff_t>(Row) * DirectoryWidth;
+        const size_t Destination = static_cast<size_t>(Row + DirectoryMinY - MinY) * NewWidth + (DirectoryMinX - MinX);
+        std::copy(Source, Source + DirectoryWidth, NewDirectory.begin() + static_cast<ptrdiff_t>(Destination));
+    }
+    Directory.swap(NewDirectory);
+    DirectoryMinX = MinX;
+    DirectoryMinY = MinY;
+    DirectoryWidth = NewWidth;
+    DirectoryHeight = NewHeight;
+}
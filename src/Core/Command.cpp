@@ -0,0 +1,62 @@
+#include "CellularSimulator/Core/Command.h"
+#include "CellularSimulator/Core/Cell.h"
+#include "CellularSimulator/Core/Simulator.h"
+
+using namespace CellularSimulator::Core;
+
+void Command::ExecuteBatch(Simulator& Sim, CellIdView Agents)
+{
+    for (const CellId Id : Agents)
+    {
+        Cell Agent = Sim.GetCell(Id);
+        Execute(Sim, Agent);
+    }
+}
+
+namespace
+{
+template <typename TWorld>
+void ExecuteBatchInWorld(Command& Cmd, const TWorld& World, CellIdView Agents)
+{
+    if (Cmd.GetTarget() == ECommandTarget::Self)
+    {
+        Cmd.ExecuteBatch(World.GetSimulator(), Agents);
+        return;
+    }
+    for (const CellId Id : Agents)
+    {
+        Cell Agent = World.GetCell(Id);
+        Cmd.ExecuteIn(World, Agent);
+    }
+}
+} // namespace
+
+void Command::ExecuteIn(const BoundedWorld& World, Cell& Agent)
+{
+    Execute(World.GetSimulator(), Agent);
+}
+
+void Command::ExecuteIn(const UnboundedWorld& World, Cell& Agent)
+{
+    Execute(World.GetSimulator(), Agent);
+}
+
+void Command::ExecuteIn(const ToroidalWorld& World, Cell& Agent)
+{
+    Execute(World.GetSimulator(), Agent);
+}
+
+void Command::ExecuteBatchIn(const BoundedWorld& World, CellIdView Agents)
+{
+    ExecuteBatchInWorld(*this, World, Agents);
+}
+
+void Command::ExecuteBatchIn(const UnboundedWorld& World, CellIdView Agents)
+{
+    ExecuteBatchInWorld(*this, World, Agents);
+}
+
+void Command::ExecuteBatchIn(const ToroidalWorld& World, CellIdView Agents)
+{
+    ExecuteBatchInWorld(*this, World, Agents);
+}
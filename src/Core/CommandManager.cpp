@@ -4,39 +4,107 @@
 
 using namespace CellularSimulator::Core;
 
-Command* CommandManager::GetCommand(size_t CommandNameHash)
+Command* CommandManager::GetCommand(Opcode CommandOpcode)
 {
-    auto& Registry = GetRegistry();
-    auto it = Registry.find(CommandNameHash);
-    if (it != Registry.end())
+    return GetRegistry().Table[CommandOpcode];
+}
+
+const CommandManager::DispatchTable& CommandManager::GetDispatchTable()
+{
+    return GetRegistry().Table;
+}
+
+bool CommandManager::RegisterCommand(std::string_view CommandName, std::unique_ptr<Command> CommandInstance, Opcode& OutOpcode)
+{
+    Registry& Commands = GetRegistry();
+    const size_t Hash = StringInterner::GetInstance().Intern(CommandName);
+    for (size_t i = 0; i < Commands.NameHashes.size(); ++i)
+    {
+        if (Commands.NameHashes[i] == Hash)
+        {
+            OutOpcode = static_cast<Opcode>(i);
+            return true;
+        }
+    }
+    // Genes are stored as single-byte opcodes, so the registry cannot grow past that.
+    if (Commands.Commands.size() >= MaxCommands) return false;
+
+    const Opcode NewOpcode = static_cast<Opcode>(Commands.Commands.size());
+    Commands.Table[NewOpcode] = CommandInstance.get();
+    Commands.Commands.push_back(std::move(CommandInstance));
+    Commands.NameHashes.push_back(Hash);
+    Commands.GeneColors[NewOpcode] = StringInterner::GetInstance().GetGeneColor(Hash);
+    OutOpcode = NewOpcode;
+    return true;
+}
+
+size_t CommandManager::GetRegisteredCommandCount()
+{
+    return GetRegistry().Commands.size();
+}
+
+bool CommandManager::FindOpcode(std::string_view CommandName, Opcode& OutOpcode)
+{
+    const Registry& Commands = GetRegistry();
+    for (size_t i = 0; i < Commands.NameHashes.size(); ++i)
     {
-        return it->second.get();
+        if (StringInterner::GetInstance().Resolve(Commands.NameHashes[i]) == CommandName)
+        {
+            OutOpcode = static_cast<Opcode>(i);
+            return true;
+        }
     }
-    return nullptr;
+    return false;
+}
+
+std::string_view CommandManager::GetCommandName(Opcode CommandOpcode)
+{
+    const Registry& Commands = GetRegistry();
+    if (CommandOpcode >= Commands.NameHashes.size()) return "UNKNOWN_OPCODE";
+    return StringInterner::GetInstance().Resolve(Commands.NameHashes[CommandOpcode]);
 }
 
-void CommandManager::RegisterCommand(std::string_view CommandName, std::unique_ptr<Command> CommandInstance)
+size_t CommandManager::GetCommandNameHash(Opcode CommandOpcode)
 {
-    size_t Hash = StringInterner::GetInstance().Intern(CommandName);
-    if (GetRegistry().find(Hash) == GetRegistry().end())
+    const Registry& Commands = GetRegistry();
+    if (CommandOpcode >= Commands.NameHashes.size()) return std::numeric_limits<size_t>::max();
+    return Commands.NameHashes[CommandOpcode];
+}
+
+std::vector<std::string> CommandManager::ResolveGenome(GenomeView Genome)
+{
+    std::vector<std::string> ResolvedGenome(Genome.size());
+    for (size_t i = 0; i < Genome.size(); ++i)
     {
-        GetRegistry()[Hash] = std::move(CommandInstance);
+        ResolvedGenome[i] = GetCommandName(Genome[i]);
     }
+    return ResolvedGenome;
+}
+
+CellColor CommandManager::GetGeneColor(Opcode CommandOpcode)
+{
+    return GetRegistry().GeneColors[CommandOpcode];
 }
 
-std::vector<size_t> CommandManager::GetRegisteredCommandNamesHashes()
+CellColor CommandManager::ComputeGenomeColor(GenomeView Genome)
 {
-    std::vector<std::size_t> Hashes;
-    Hashes.reserve(GetRegistry().size());
-    for (const auto& pair : GetRegistry())
+    const size_t GenomeSize = Genome.size();
+    if (GenomeSize == 0) return {80, 80, 80, 255};
+    const Registry& Commands = GetRegistry();
+    float TotalR = 0, TotalG = 0, TotalB = 0;
+    for (size_t i = 0; i < GenomeSize; ++i)
     {
-        Hashes.push_back(pair.first);
+        const float Weight = 1.0f - (static_cast<float>(i) / GenomeSize);
+        const CellColor& GeneColor = Commands.GeneColors[Genome[i]];
+        TotalR += GeneColor.R * Weight;
+        TotalG += GeneColor.G * Weight;
+        TotalB += GeneColor.B * Weight;
     }
-    return Hashes;
+    return {static_cast<uint8_t>(TotalR / GenomeSize), static_cast<uint8_t>(TotalG / GenomeSize), static_cast<uint8_t>(TotalB / GenomeSize), 255};
 }
 
-CommandManager::FactoryMap& CommandManager::GetRegistry()
+CommandManager::Registry& CommandManager::GetRegistry()
 {
-    static FactoryMap Registry;
-    return Registry;
+    static Registry Instance;
+    return Instance;
 }
\ No newline at end of file
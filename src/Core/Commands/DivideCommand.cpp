@@ -1,6 +1,5 @@
 ﻿#include "CellularSimulator/Core/Commands/DivideCommand.h"
 #include <cstdint>
-#include <random>
 #include "CellularSimulator/Core/Cell.h"
 #include "CellularSimulator/Core/CellSimulatorTypes.h"
 #include "CellularSimulator/Core/CommandRegistry.h"
@@ -8,30 +7,52 @@
 
 using namespace CellularSimulator::Core;
 
-void DivideCommand::Execute(Simulator& Sim, Cell& Agent)
+namespace
+{
+template <typename TWorld>
+void Divide(TWorld& World, Cell& Agent)
 {
     const EDirection Direction = Agent.GetDirection();
     int32_t NextX;
     int32_t NextY;
     GetForwardXY(Direction, NextX, NextY, Agent.GetX(), Agent.GetY());
-    if (!Sim.IsTileValidAndEmpty(NextX, NextY)) return;
-    std::vector<size_t> NewGenome = Agent.GetGenome();
-    std::uniform_real_distribution<float> MutationChance(0.0f, 1.0f);
-    std::mt19937& Rng = Sim.GetRNG(); 
-    if (MutationChance(Rng) < 0.05f)
+    if (!World.IsTileValidAndEmpty(NextX, NextY)) return;
+    Cell Child = World.SpawnCell(NextX, NextY, Direction, Agent.GetGenomeId(), Agent.GetEnergy() / 2.f);
+    if (!Child.IsValid()) return;
+    CounterRng Rng = World.GetRandomStream(Agent.GetId());
+    if (Rng.NextFloat() < 0.05f)
     {
-        const auto AvailableCommands = CommandManager::GetRegisteredCommandNamesHashes();
-        if (!AvailableCommands.empty())
+        const size_t CommandCount = CommandManager::GetRegisteredCommandCount();
+        const size_t GenomeSize = Child.GetGenome().size();
+        if (CommandCount > 0 && GenomeSize > 0)
         {
-            std::uniform_int_distribution<size_t> CmdIndex(0, AvailableCommands.size() - 1);
-            std::uniform_int_distribution<size_t> GeneIndex(0, NewGenome.size() - 1);
-
-            NewGenome[GeneIndex(Rng)] = AvailableCommands[CmdIndex(Rng)];
+            const uint32_t GeneIndex = Rng.NextBelow(static_cast<uint32_t>(GenomeSize));
+            Child.SetGene(GeneIndex, static_cast<Opcode>(Rng.NextBelow(static_cast<uint32_t>(CommandCount))));
         }
     }
-    Sim.SpawnCell(NextX, NextY, Agent.GetDirection(), NewGenome, Agent.GetEnergy() / 2.f);
     Agent.ConsumeEnergy(Agent.GetEnergy() / 2.f);
 }
+} // namespace
+
+void DivideCommand::Execute(Simulator& Sim, Cell& Agent)
+{
+    Divide(Sim, Agent);
+}
+
+void DivideCommand::ExecuteIn(const BoundedWorld& World, Cell& Agent)
+{
+    Divide(World, Agent);
+}
+
+void DivideCommand::ExecuteIn(const UnboundedWorld& World, Cell& Agent)
+{
+    Divide(World, Agent);
+}
+
+void DivideCommand::ExecuteIn(const ToroidalWorld& World, Cell& Agent)
+{
+    Divide(World, Agent);
+}
 
 namespace
 {
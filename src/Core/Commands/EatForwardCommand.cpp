@@ -1,4 +1,5 @@
 ﻿#include "CellularSimulator/Core/Commands/EatForwardCommand.h"
+#include <algorithm>
 #include "CellularSimulator/Core/Cell.h"
 #include "CellularSimulator/Core/CommandRegistry.h"
 #include "CellularSimulator/Core/GridTile.h"
@@ -6,17 +7,43 @@
 
 using namespace CellularSimulator::Core;
 
-void EatForwardCommand::Execute(Simulator& Sim, Cell& Agent)
+namespace
+{
+template <typename TWorld>
+void EatForward(TWorld& World, Cell& Agent)
 {
     int32_t NextX, NextY;
     GetForwardXY(Agent.GetDirection(), NextX, NextY, Agent.GetX(), Agent.GetY());
-    GridTile* TargetTile = Sim.GetTile(NextX, NextY);
+    GridTile* TargetTile = World.GetTile(NextX, NextY);
     if (!TargetTile || !TargetTile->HasCell()) return;
-    Cell* Victim = TargetTile->GetCell();
-    if (!Victim) return;
-    const float EnergySteal = std::min(20.f, Victim->GetEnergy());
-    Victim->ConsumeEnergy(EnergySteal);
+    Cell Victim = World.GetCell(TargetTile->GetCellId());
+    if (!Victim.IsValid()) return;
+    const float VictimEnergy = Victim.GetEnergy();
+    const float EnergySteal = std::min(20.f, VictimEnergy);
+    Victim.ConsumeEnergy(EnergySteal);
     Agent.AddEnergy(EnergySteal);
+    if (VictimEnergy > 0.0f && Victim.GetEnergy() <= 0.0f) World.RecordKill();
+}
+} // namespace
+
+void EatForwardCommand::Execute(Simulator& Sim, Cell& Agent)
+{
+    EatForward(Sim, Agent);
+}
+
+void EatForwardCommand::ExecuteIn(const BoundedWorld& World, Cell& Agent)
+{
+    EatForward(World, Agent);
+}
+
+void EatForwardCommand::ExecuteIn(const UnboundedWorld& World, Cell& Agent)
+{
+    EatForward(World, Agent);
+}
+
+void EatForwardCommand::ExecuteIn(const ToroidalWorld& World, Cell& Agent)
+{
+    EatForward(World, Agent);
 }
 
 namespace
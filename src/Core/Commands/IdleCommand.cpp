@@ -3,7 +3,11 @@
 
 using namespace CellularSimulator::Core;
 
-void IdleCommand::Execute(Simulator& Sim, Cell& Agent)
+void IdleCommand::Execute([[maybe_unused]] Simulator& Sim, [[maybe_unused]] Cell& Agent)
+{
+}
+
+void IdleCommand::ExecuteBatch([[maybe_unused]] Simulator& Sim, [[maybe_unused]] CellIdView Agents)
 {
 }
 
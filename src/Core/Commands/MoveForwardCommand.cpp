@@ -7,17 +7,41 @@
 
 using namespace CellularSimulator::Core;
 
-void MoveForwardCommand::Execute(Simulator& Sim, Cell& Agent)
+namespace
+{
+template <typename TWorld>
+void MoveForward(TWorld& World, Cell& Agent)
 {
     const EDirection Direction = Agent.GetDirection();
     int32_t NextX;
     int32_t NextY;
     GetForwardXY(Direction, NextX, NextY, Agent.GetX(), Agent.GetY());
-    if (Sim.IsTileValidAndEmpty(NextX, NextY))
+    if (World.IsTileValidAndEmpty(NextX, NextY))
     {
-        Sim.MoveCell(&Agent, NextX, NextY);
+        World.MoveCell(Agent, NextX, NextY);
     }
 }
+} // namespace
+
+void MoveForwardCommand::Execute(Simulator& Sim, Cell& Agent)
+{
+    MoveForward(Sim, Agent);
+}
+
+void MoveForwardCommand::ExecuteIn(const BoundedWorld& World, Cell& Agent)
+{
+    MoveForward(World, Agent);
+}
+
+void MoveForwardCommand::ExecuteIn(const UnboundedWorld& World, Cell& Agent)
+{
+    MoveForward(World, Agent);
+}
+
+void MoveForwardCommand::ExecuteIn(const ToroidalWorld& World, Cell& Agent)
+{
+    MoveForward(World, Agent);
+}
 
 namespace
 {
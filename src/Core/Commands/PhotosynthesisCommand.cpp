@@ -1,14 +1,25 @@
 ﻿#include "CellularSimulator/Core/Commands/PhotosynthesisCommand.h"
+#include <algorithm>
 #include "CellularSimulator/Core/Cell.h"
 #include "CellularSimulator/Core/CommandRegistry.h"
+#include "CellularSimulator/Core/Simulator.h"
 
 using namespace CellularSimulator::Core;
 
-void PhotosynthesisCommand::Execute(Simulator& Sim, Cell& Agent)
+void PhotosynthesisCommand::Execute([[maybe_unused]] Simulator& Sim, Cell& Agent)
 {
     Agent.AddEnergy(20.0f);
 }
 
+void PhotosynthesisCommand::ExecuteBatch(Simulator& Sim, CellIdView Agents)
+{
+    float* Energy = Sim.GetCellStore().GetEnergyData();
+    for (const CellId Id : Agents)
+    {
+        Energy[Id] = std::min(CellStore::MaxEnergy, Energy[Id] + 20.0f);
+    }
+}
+
 namespace
 {
 const CommandRegistrar<PhotosynthesisCommand> Registrar("Photosynthesis");
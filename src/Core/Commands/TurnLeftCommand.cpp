@@ -1,14 +1,24 @@
 #include "CellularSimulator/Core/Commands/TurnLeftCommand.h"
 #include "CellularSimulator/Core/Cell.h"
 #include "CellularSimulator/Core/CommandRegistry.h"
+#include "CellularSimulator/Core/Simulator.h"
 
 using namespace CellularSimulator::Core;
 
-void TurnLeftCommand::Execute(Simulator& Sim, Cell& Agent)
+void TurnLeftCommand::Execute([[maybe_unused]] Simulator& Sim, Cell& Agent)
 {
     Agent.SetDirection(TurnLeft(Agent.GetDirection()));
 }
 
+void TurnLeftCommand::ExecuteBatch(Simulator& Sim, CellIdView Agents)
+{
+    CellStore& Cells = Sim.GetCellStore();
+    for (const CellId Id : Agents)
+    {
+        Cells.SetDirection(Id, TurnLeft(Cells.GetDirection(Id)));
+    }
+}
+
 namespace
 {
 const CommandRegistrar<TurnLeftCommand> Registrar("TurnLeft");
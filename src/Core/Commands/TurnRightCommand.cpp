@@ -1,14 +1,24 @@
 ﻿#include "CellularSimulator/Core/Commands/TurnRightCommand.h"
 #include "CellularSimulator/Core/Cell.h"
 #include "CellularSimulator/Core/CommandRegistry.h"
+#include "CellularSimulator/Core/Simulator.h"
 
 using namespace CellularSimulator::Core;
 
-void TurnRightCommand::Execute(Simulator& Sim, Cell& Agent)
+void TurnRightCommand::Execute([[maybe_unused]] Simulator& Sim, Cell& Agent)
 {
     Agent.SetDirection(TurnRight(Agent.GetDirection()));
 }
 
+void TurnRightCommand::ExecuteBatch(Simulator& Sim, CellIdView Agents)
+{
+    CellStore& Cells = Sim.GetCellStore();
+    for (const CellId Id : Agents)
+    {
+        Cells.SetDirection(Id, TurnRight(Cells.GetDirection(Id)));
+    }
+}
+
 namespace
 {
 const CommandRegistrar<TurnRightCommand> Registrar("TurnRight");
@@ -0,0 +1,196 @@
+#include "CellularSimulator/Core/GenomeTable.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include "CellularSimulator/Core/CommandManager.h"
+#include "CellularSimulator/Core/LineageRecorder.h"
+
+using namespace CellularSimulator::Core;
+
+namespace
+{
+uint64_t Mix(uint64_t Value)
+{
+    Value ^= Value >> 30;
+    Value *= 0xBF58476D1CE4E5B9ull;
+    Value ^= Value >> 27;
+    Value *= 0x94D049BB133111EBull;
+    Value ^= Value >> 31;
+    return Value;
+}
+
+/**
+ * Hashes the genes eight at a time. The edit is applied to the word that contains it,
+ * so a mutated genome is hashed without copying its genes first.
+ */
+uint64_t HashGenes(const Opcode* Genes, size_t Length, size_t EditIndex, Opcode EditGene)
+{
+    uint64_t Hash = 0x9E3779B97F4A7C15ull ^ Length;
+    for (size_t Offset = 0; Offset < Length; Offset += sizeof(uint64_t))
+    {
+        const size_t Bytes = std::min(sizeof(uint64_t), Length - Offset);
+        uint8_t Word[sizeof(uint64_t)] = {};
+        std::memcpy(Word, Genes + Offset, Bytes);
+        if (EditIndex - Offset < Bytes) Word[EditIndex - Offset] = EditGene;
+        uint64_t Value;
+        std::memcpy(&Value, Word, sizeof(Value));
+        Hash = Mix(Hash ^ Value);
+    }
+    return Hash;
+}
+
+Opcode ParentGene(const Opcode* Source, GenomeId Base, size_t EditIndex)
+{
+    return Base != InvalidGenomeId ? Source[EditIndex] : 0;
+}
+} // namespace
+
+void GenomeTable::Reset(size_t InGenomeLength)
+{
+    // The directory has a slot for every block up front, so adding a block never moves it under readers.
+    Blocks.resize(MaxBlocks);
+    // Blocks are kept for the next genomes unless their stride changes.
+    if (InGenomeLength != GenomeLength)
+    {
+        for (size_t i = 0; i < BlockCount; ++i)
+        {
+            Blocks[i].reset();
+        }
+        BlockCount = 0;
+        GenomeLength = InGenomeLength;
+    }
+    EntryCount = 0;
+    FreeIds.clear();
+    GenomeCount.store(0, std::memory_order_relaxed);
+    std::fill(Index.begin(), Index.end(), InvalidGenomeId);
+    if (Lineage) Lineage->OnReset();
+}
+
+GenomeId GenomeTable::Intern(GenomeView InGenes)
+{
+    return InternImpl(InGenes.data(), InvalidGenomeId, NoEdit, 0);
+}
+
+GenomeId GenomeTable::InternEdited(GenomeId Base, size_t EditIndex, Opcode Gene)
+{
+    return InternImpl(GetGenes(Base).data(), Base, EditIndex, Gene);
+}
+
+GenomeId GenomeTable::InternImpl(const Opcode* Source, GenomeId Base, size_t EditIndex, Opcode EditGene)
+{
+    const uint64_t Hash = HashGenes(Source, GenomeLength, EditIndex, EditGene);
+    std::lock_guard<std::mutex> Lock(Mutex);
+    size_t Mask = Index.size() - 1;
+    if (!Index.empty())
+    {
+        for (size_t Slot = Hash & Mask; Index[Slot] != InvalidGenomeId; Slot = (Slot + 1) & Mask)
+        {
+            const GenomeId Id = Index[Slot];
+            if (GetBlock(Id).Hashes[Id & BlockMask] == Hash && Matches(Id, Source, EditIndex, EditGene))
+            {
+                // An unreferenced genome that has not been swept yet comes back to life.
+                if (GetBlock(Id).References[Id & BlockMask].fetch_add(1, std::memory_order_relaxed) == 0)
+                {
+                    GenomeCount.fetch_add(1, std::memory_order_relaxed);
+                    if (Lineage) Lineage->OnGenomeAdded(Id, GetGenes(Id), Base, EditIndex, ParentGene(Source, Base, EditIndex), false);
+                }
+                return Id;
+            }
+        }
+    }
+
+    const GenomeId Id = AllocateEntry();
+    Block& Entries = GetBlock(Id);
+    const GenomeId Local = Id & BlockMask;
+    Opcode* Destination = Entries.Genes.get() + Local * GenomeLength;
+    if (GenomeLength > 0) std::memcpy(Destination, Source, GenomeLength * sizeof(Opcode));
+    if (EditIndex < GenomeLength) Destination[EditIndex] = EditGene;
+    Entries.Colors[Local] = CommandManager::ComputeGenomeColor({Destination, GenomeLength});
+    Entries.Hashes[Local] = Hash;
+    Entries.References[Local].store(1, std::memory_order_relaxed);
+    Entries.LiveFlags[Local] = 1;
+    GenomeCount.fetch_add(1, std::memory_order_relaxed);
+
+    Mask = Index.size() - 1;
+    size_t Slot = Hash & Mask;
+    while (Index[Slot] != InvalidGenomeId)
+    {
+        Slot = (Slot + 1) & Mask;
+    }
+    Index[Slot] = Id;
+    if (Lineage) Lineage->OnGenomeAdded(Id, GetGenes(Id), Base, EditIndex, ParentGene(Source, Base, EditIndex), true);
+    return Id;
+}
+
+bool GenomeTable::Matches(GenomeId Id, const Opcode* Source, size_t EditIndex, Opcode EditGene) const
+{
+    const Opcode* Stored = GetGenes(Id).data();
+    if (EditIndex >= GenomeLength) return GenomeLength == 0 || std::memcmp(Stored, Source, GenomeLength * sizeof(Opcode)) == 0;
+    return Stored[EditIndex] == EditGene
+        && std::memcmp(Stored, Source, EditIndex * sizeof(Opcode)) == 0
+        && std::memcmp(Stored + EditIndex + 1, Source + EditIndex + 1, (GenomeLength - EditIndex - 1) * sizeof(Opcode)) == 0;
+}
+
+GenomeId GenomeTable::AllocateEntry()
+{
+    const size_t IndexedCount = EntryCount - FreeIds.size();
+    const size_t UnreferencedCount = IndexedCount - GenomeCount.load(std::memory_order_relaxed);
+    // Sweeping scans every entry, so it waits until it frees a constant share of them.
+    if (FreeIds.empty() && UnreferencedCount > 0 && UnreferencedCount * 4 >= EntryCount) SweepUnreferenced();
+
+    GenomeId Id;
+    if (!FreeIds.empty())
+    {
+        Id = FreeIds.back();
+        FreeIds.pop_back();
+    }
+    else
+    {
+        Id = EntryCount++;
+        if ((Id >> BlockShift) >= BlockCount) Blocks[BlockCount++] = std::make_unique<Block>(GenomeLength);
+    }
+    if ((EntryCount - FreeIds.size()) * 2 > Index.size()) RebuildIndex(std::max<size_t>(Index.size() * 2, 64));
+    return Id;
+}
+
+void GenomeTable::SweepUnreferenced()
+{
+    // Only Intern revives unreferenced genomes and it holds the lock, so they can be recycled safely.
+    for (GenomeId Id = 0; Id < EntryCount; ++Id)
+    {
+        Block& Entries = GetBlock(Id);
+        const GenomeId Local = Id & BlockMask;
+        if (Entries.LiveFlags[Local] && Entries.References[Local].load(std::memory_order_relaxed) == 0)
+        {
+            Entries.LiveFlags[Local] = 0;
+            FreeIds.push_back(Id);
+        }
+    }
+    // The lowest ids are reused first, which keeps the live entries packed into the first blocks.
+    std::sort(FreeIds.begin(), FreeIds.end(), std::greater<GenomeId>());
+    RebuildIndex(Index.size());
+}
+
+void GenomeTable::RebuildIndex(size_t IndexSize)
+{
+    Index.assign(IndexSize, InvalidGenomeId);
+    const size_t Mask = IndexSize - 1;
+    for (GenomeId Id = 0; Id < EntryCount; ++Id)
+    {
+        const Block& Entries = GetBlock(Id);
+        if (!Entries.LiveFlags[Id & BlockMask]) continue;
+        size_t Slot = Entries.Hashes[Id & BlockMask] & Mask;
+        while (Index[Slot] != InvalidGenomeId)
+        {
+            Slot = (Slot + 1) & Mask;
+        }
+        Index[Slot] = Id;
+    }
+}
+
+void GenomeTable::ReportExtinction(GenomeId Id)
+{
+    // Intern may have revived the genome since the last reference was dropped, the lock settles which came last.
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (GetReferenceCount(Id) == 0) Lineage->OnGenomeExtinct(Id);
+}
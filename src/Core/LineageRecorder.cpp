@@ -0,0 +1,271 @@
+#include "CellularSimulator/Core/LineageRecorder.h"
+#include <algorithm>
+#include <cstring>
+#include "CellularSimulator/Core/CommandManager.h"
+
+using namespace CellularSimulator::Core;
+
+/*
+ * Lineage file layout, all values in host byte order (the header records it):
+ *
+ *   LineageHeader
+ *   OpcodeCount x { uint16_t NameLength; char Name[NameLength]; }
+ *   Records, each a LineageRecorder::Record, founders followed by uint8_t Genes[GenomeLength]
+ *
+ * Records appear in the order they were written: pruning-resistant ancestors first, in order of extinction,
+ * then every genotype still in memory at the end. Genes of other genotypes follow from their founder and the
+ * chain of mutations.
+ */
+
+namespace
+{
+constexpr char LineageMagic[8] = {'C', 'E', 'L', 'L', 'L', 'I', 'N', 'E'};
+constexpr uint32_t LineageVersion = 1;
+constexpr uint32_t ByteOrderMark = 0x01020304u;
+constexpr size_t FlushThreshold = size_t{1} << 20;
+
+struct LineageHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t ByteOrder;
+    uint32_t GenomeLength;
+    uint32_t OpcodeCount;
+    uint32_t RecordSize;
+    uint32_t Reserved;
+};
+
+template <typename T>
+void AppendValue(std::vector<char>& Buffer, const T& Value)
+{
+    const char* Bytes = reinterpret_cast<const char*>(&Value);
+    Buffer.insert(Buffer.end(), Bytes, Bytes + sizeof(T));
+}
+} // namespace
+
+LineageRecorder::~LineageRecorder()
+{
+    Close();
+}
+
+bool LineageRecorder::Open(const std::string& Path, size_t InGenomeLength, size_t InMaxRetainedAncestors)
+{
+    Close();
+    Stream.open(Path, std::ios::binary | std::ios::trunc);
+    if (!Stream) return false;
+    GenomeLength = InGenomeLength;
+    MaxRetainedAncestors = InMaxRetainedAncestors;
+    WrittenCount = 0;
+    NextGenotype = 1;
+    ClearState();
+
+    const size_t CommandCount = CommandManager::GetRegisteredCommandCount();
+    LineageHeader Header{};
+    std::memcpy(Header.Magic, LineageMagic, sizeof(LineageMagic));
+    Header.Version = LineageVersion;
+    Header.ByteOrder = ByteOrderMark;
+    Header.GenomeLength = static_cast<uint32_t>(GenomeLength);
+    Header.OpcodeCount = static_cast<uint32_t>(CommandCount);
+    Header.RecordSize = sizeof(Record);
+    AppendValue(Buffer, Header);
+    for (size_t i = 0; i < CommandCount; ++i)
+    {
+        const std::string_view Name = CommandManager::GetCommandName(static_cast<Opcode>(i));
+        AppendValue(Buffer, static_cast<uint16_t>(Name.size()));
+        Buffer.insert(Buffer.end(), Name.begin(), Name.end());
+    }
+    FlushBuffer();
+    return static_cast<bool>(Stream);
+}
+
+bool LineageRecorder::Close()
+{
+    if (!Stream.is_open()) return true;
+    WriteRetained(false);
+    FlushBuffer();
+    const bool bWritten = static_cast<bool>(Stream);
+    Stream.close();
+    return bWritten;
+}
+
+void LineageRecorder::OnGenomeAdded(GenomeId Genome, GenomeView Genes, GenomeId Parent, size_t MutationSite, Opcode OldGene, bool bNewEntry)
+{
+    if (Genome >= NodeOfGenome.size()) NodeOfGenome.resize(std::max<size_t>(Genome + 1, NodeOfGenome.size() * 2), NoNode);
+    if (NodeOfGenome[Genome] != NoNode)
+    {
+        // A genome revived before its extinction was reported simply continues its genotype.
+        if (!bNewEntry) return;
+        // The id was reused for another genome before the extinction of the previous one was reported.
+        MarkExtinct(NodeOfGenome[Genome]);
+    }
+
+    const uint32_t ParentIndex = Parent < NodeOfGenome.size() ? NodeOfGenome[Parent] : NoNode;
+    const uint32_t Index = AllocateNode();
+    Node& NewNode = Nodes[Index];
+    NewNode.Genome = Genome;
+    if (ParentIndex != NoNode)
+    {
+        Node& ParentNode = Nodes[ParentIndex];
+        ++ParentNode.RetainedChildren;
+        NewNode.ParentNode = ParentIndex;
+        NewNode.ParentSerial = ParentNode.Serial;
+        NewNode.Data.MutationSite = static_cast<uint16_t>(MutationSite);
+        NewNode.Data.OldGene = OldGene;
+        NewNode.Data.NewGene = Genes[MutationSite];
+    }
+    std::copy(Genes.begin(), Genes.end(), NodeGenes.begin() + static_cast<ptrdiff_t>(Index * GenomeLength));
+    NodeOfGenome[Genome] = Index;
+    NewNodes.push_back({Index, NewNode.Serial});
+}
+
+void LineageRecorder::OnGenomeExtinct(GenomeId Genome)
+{
+    if (Genome < NodeOfGenome.size() && NodeOfGenome[Genome] != NoNode) MarkExtinct(NodeOfGenome[Genome]);
+}
+
+void LineageRecorder::OnReset()
+{
+    // The cleared world takes every genotype with it, later genomes start new lineages.
+    if (Stream.is_open()) WriteRetained(true);
+}
+
+void LineageRecorder::WriteRetained(bool bExtinct)
+{
+    NumberNewGenotypes(CurrentTick);
+    for (uint32_t Index = 0; Index < Nodes.size(); ++Index)
+    {
+        if (Nodes[Index].Serial == 0) continue;
+        if (bExtinct && Nodes[Index].Genome != InvalidGenomeId) Nodes[Index].Data.ExtinctionTick = CurrentTick;
+        WriteNode(Index);
+    }
+    ClearState();
+}
+
+void LineageRecorder::ClearState()
+{
+    Nodes.clear();
+    NodeGenes.clear();
+    FreeNodes.clear();
+    NodeOfGenome.clear();
+    NewNodes.clear();
+    Ancestors.clear();
+    RetainedAncestorCount = 0;
+}
+
+void LineageRecorder::EndTick(uint64_t Tick)
+{
+    NumberNewGenotypes(Tick);
+    // Ancestors that outlived the retention limit are written and become permanent.
+    while (RetainedAncestorCount > MaxRetainedAncestors && !Ancestors.empty())
+    {
+        const NodeLink Link = Ancestors.front();
+        Ancestors.pop_front();
+        if (!IsLinked(Link)) continue;
+        WriteNode(Link.Index);
+        FreeNode(Link.Index);
+        --RetainedAncestorCount;
+    }
+    // Pruned ancestors leave stale entries behind, drop them before they outnumber the live ones.
+    if (Ancestors.size() > 2 * RetainedAncestorCount + 1024)
+    {
+        Ancestors.erase(std::remove_if(Ancestors.begin(), Ancestors.end(), [this](NodeLink Link) { return !IsLinked(Link); }), Ancestors.end());
+    }
+    if (Buffer.size() >= FlushThreshold) FlushBuffer();
+}
+
+uint32_t LineageRecorder::AllocateNode()
+{
+    uint32_t Index;
+    if (!FreeNodes.empty())
+    {
+        Index = FreeNodes.back();
+        FreeNodes.pop_back();
+    }
+    else
+    {
+        Index = static_cast<uint32_t>(Nodes.size());
+        Nodes.emplace_back();
+        NodeGenes.resize(NodeGenes.size() + GenomeLength);
+    }
+    Nodes[Index] = {};
+    Nodes[Index].Data.BirthTick = CurrentTick;
+    Nodes[Index].Serial = NextSerial++;
+    return Index;
+}
+
+void LineageRecorder::FreeNode(uint32_t Index)
+{
+    Nodes[Index].Serial = 0;
+    FreeNodes.push_back(Index);
+}
+
+void LineageRecorder::MarkExtinct(uint32_t Index)
+{
+    Node& Extinct = Nodes[Index];
+    Extinct.Data.ExtinctionTick = CurrentTick;
+    NodeOfGenome[Extinct.Genome] = NoNode;
+    Extinct.Genome = InvalidGenomeId;
+    if (Extinct.RetainedChildren > 0)
+    {
+        Ancestors.push_back({Index, Extinct.Serial});
+        ++RetainedAncestorCount;
+        return;
+    }
+    Prune(Index);
+}
+
+void LineageRecorder::Prune(uint32_t Index)
+{
+    // Walks up while the branch holds nothing but extinct genotypes.
+    while (true)
+    {
+        const NodeLink Parent{Nodes[Index].ParentNode, Nodes[Index].ParentSerial};
+        FreeNode(Index);
+        // A parent that was already written stays in the file.
+        if (!IsLinked(Parent)) return;
+        Node& ParentNode = Nodes[Parent.Index];
+        if (--ParentNode.RetainedChildren > 0 || ParentNode.Genome != InvalidGenomeId) return;
+        --RetainedAncestorCount;
+        Index = Parent.Index;
+    }
+}
+
+void LineageRecorder::NumberNewGenotypes(uint64_t Tick)
+{
+    NewNodes.erase(std::remove_if(NewNodes.begin(), NewNodes.end(), [this](NodeLink Link) { return !IsLinked(Link); }), NewNodes.end());
+    const Opcode* Genes = NodeGenes.data();
+    const size_t Length = GenomeLength;
+    std::stable_sort(NewNodes.begin(), NewNodes.end(), [Genes, Length](NodeLink A, NodeLink B) {
+        return std::lexicographical_compare(Genes + A.Index * Length, Genes + (A.Index + 1) * Length, Genes + B.Index * Length, Genes + (B.Index + 1) * Length);
+    });
+    for (const NodeLink Link : NewNodes)
+    {
+        Nodes[Link.Index].Data.Genotype = NextGenotype++;
+        Nodes[Link.Index].Data.BirthTick = Tick;
+    }
+    // Parents may have been born in the same tick, so they are resolved once every genotype has its number.
+    for (const NodeLink Link : NewNodes)
+    {
+        Node& NewNode = Nodes[Link.Index];
+        if (IsLinked({NewNode.ParentNode, NewNode.ParentSerial})) NewNode.Data.Parent = Nodes[NewNode.ParentNode].Data.Genotype;
+    }
+    NewNodes.clear();
+}
+
+void LineageRecorder::WriteNode(uint32_t Index)
+{
+    const Node& Written = Nodes[Index];
+    AppendValue(Buffer, Written.Data);
+    if (Written.Data.Parent == 0)
+    {
+        const auto FirstGene = NodeGenes.begin() + static_cast<ptrdiff_t>(Index * GenomeLength);
+        Buffer.insert(Buffer.end(), FirstGene, FirstGene + static_cast<ptrdiff_t>(GenomeLength));
+    }
+    ++WrittenCount;
+}
+
+void LineageRecorder::FlushBuffer()
+{
+    Stream.write(Buffer.data(), static_cast<std::streamsize>(Buffer.size()));
+    Buffer.clear();
+}
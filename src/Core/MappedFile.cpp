@@ -0,0 +1,102 @@
+#include "CellularSimulator/Core/MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace CellularSimulator::Core;
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& Path)
+{
+    Close();
+    HANDLE File = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (File == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER FileSize;
+    if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart == 0)
+    {
+        CloseHandle(File);
+        return false;
+    }
+
+    HANDLE Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!Mapping)
+    {
+        CloseHandle(File);
+        return false;
+    }
+
+    const void* View = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!View)
+    {
+        CloseHandle(Mapping);
+        CloseHandle(File);
+        return false;
+    }
+
+    FileHandle = File;
+    MappingHandle = Mapping;
+    Data = static_cast<const uint8_t*>(View);
+    Size = static_cast<size_t>(FileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (Data) UnmapViewOfFile(Data);
+    if (MappingHandle) CloseHandle(MappingHandle);
+    if (FileHandle) CloseHandle(FileHandle);
+    Data = nullptr;
+    Size = 0;
+    MappingHandle = nullptr;
+    FileHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& Path)
+{
+    Close();
+    const int File = open(Path.c_str(), O_RDONLY);
+    if (File < 0) return false;
+
+    struct stat FileStat;
+    if (fstat(File, &FileStat) != 0 || FileStat.st_size == 0)
+    {
+        close(File);
+        return false;
+    }
+
+    void* View = mmap(nullptr, static_cast<size_t>(FileStat.st_size), PROT_READ, MAP_PRIVATE, File, 0);
+    // The mapping stays valid after the descriptor is closed.
+    close(File);
+    if (View == MAP_FAILED) return false;
+
+    Data = static_cast<const uint8_t*>(View);
+    Size = static_cast<size_t>(FileStat.st_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (Data) munmap(const_cast<uint8_t*>(Data), Size);
+    Data = nullptr;
+    Size = 0;
+}
+
+#endif
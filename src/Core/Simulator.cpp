@@ -1,98 +1,642 @@
 #include "CellularSimulator/Core/Simulator.h"
+#include <algorithm>
 #include <execution>
-#include <random>
+#include <numeric>
 #include "CellularSimulator/Core/GridTile.h"
 #include "CellularSimulator/Core/Cell.h"
 #include "CellularSimulator/Core/Command.h"
 
 using namespace CellularSimulator::Core;
 
-Simulator::Simulator(int32_t InWidth, int32_t InHeight) : Width(InWidth), Height(InHeight)
+Simulator::Simulator(int32_t InWidth, int32_t InHeight, EWorldTopology InTopology)
+    : Topology(InTopology)
 {
-    Grid.resize(static_cast<size_t>(Width) * Height);
-    const size_t MaxPopulation = static_cast<size_t>(Width) * Height;
-    CellPool.resize(MaxPopulation);
+    ResizeWorld(InWidth, InHeight);
+}
+
+void Simulator::ResizeWorld(int32_t InWidth, int32_t InHeight)
+{
+    Width = InWidth;
+    Height = InHeight;
+    // Chunks and cell slots are allocated as the population needs them, nothing is sized for a full world.
+    Grid.Reset((Width + ChunkSize - 1) / ChunkSize, (Height + ChunkSize - 1) / ChunkSize);
+    ChunkPopulation.clear();
+    Cells.Resize(0, GenomeLength);
+    ActiveIds.clear();
+    TileClaims.clear();
+    DirtyBits.clear();
+    ReleasedDirtyTiles.clear();
+    MarkAllTilesDirty();
+}
+
+size_t Simulator::AcquireTile(int32_t X, int32_t Y)
+{
+    const size_t TileIndex = Grid.AcquireTile(X, Y);
+    if (Grid.GetTileCapacity() > TileClaims.size()) GrowTileState();
+    return TileIndex;
+}
+
+void Simulator::GrowTileState()
+{
+    // Grows geometrically, so a colony that keeps spreading does not rebuild the arrays for every chunk.
+    const size_t Capacity = std::max(Grid.GetTileCapacity(), TileClaims.size() * 2);
+    TileClaims = std::vector<std::atomic<uint32_t>>(Capacity);
+    for (auto& Claim : TileClaims)
+    {
+        Claim.store(UnclaimedTile, std::memory_order_relaxed);
+    }
+    std::vector<std::atomic<uint64_t>> NewDirtyBits((Capacity + 63) / 64);
+    for (size_t i = 0; i < DirtyBits.size(); ++i)
+    {
+        NewDirtyBits[i].store(DirtyBits[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    DirtyBits.swap(NewDirtyBits);
+}
+
+void Simulator::UpdateChunkResidency()
+{
+    // Cells move and divide at most one tile per tick, so keeping the neighbours of every populated chunk
+    // allocated means no command ever reaches a tile without a chunk and the grid never changes during a tick.
+    // A chunk is released once it and all of its neighbours are empty, so a border does not flicker.
+    auto HasPopulatedNeighbourhood = [this](int32_t ChunkX, int32_t ChunkY) {
+        for (int32_t OffsetY = -1; OffsetY <= 1; ++OffsetY)
+        {
+            for (int32_t OffsetX = -1; OffsetX <= 1; ++OffsetX)
+            {
+                int32_t NeighbourX = ChunkX + OffsetX;
+                int32_t NeighbourY = ChunkY + OffsetY;
+                if (!ResolveChunk(NeighbourX, NeighbourY)) continue;
+                const uint32_t Slot = Grid.FindChunk(NeighbourX, NeighbourY);
+                if (Slot != ChunkedGrid::NoChunk && ChunkPopulation[Slot] > 0) return true;
+            }
+        }
+        return false;
+    };
+
+    ReleasedChunks.clear();
+    MissingChunks.clear();
+    Grid.ForEachChunk([&](uint32_t Slot) {
+        const int32_t ChunkX = Grid.GetChunkX(Slot);
+        const int32_t ChunkY = Grid.GetChunkY(Slot);
+        if (ChunkPopulation[Slot] == 0)
+        {
+            if (!HasPopulatedNeighbourhood(ChunkX, ChunkY)) ReleasedChunks.push_back(Slot);
+            return;
+        }
+        for (int32_t OffsetY = -1; OffsetY <= 1; ++OffsetY)
+        {
+            for (int32_t OffsetX = -1; OffsetX <= 1; ++OffsetX)
+            {
+                int32_t NeighbourX = ChunkX + OffsetX;
+                int32_t NeighbourY = ChunkY + OffsetY;
+                if (ResolveChunk(NeighbourX, NeighbourY) && Grid.FindChunk(NeighbourX, NeighbourY) == ChunkedGrid::NoChunk)
+                {
+                    MissingChunks.emplace_back(NeighbourX, NeighbourY);
+                }
+            }
+        }
+    });
+
+    for (const uint32_t Slot : ReleasedChunks)
+    {
+        // The tile indices of the chunk are about to be reused, so pending changes are kept by position.
+        const size_t FirstWord = ChunkedGrid::GetFirstTile(Slot) / 64;
+        for (size_t WordIndex = FirstWord; WordIndex < FirstWord + ChunkedGrid::TilesPerChunk / 64; ++WordIndex)
+        {
+            uint64_t Word = DirtyBits[WordIndex].exchange(0, std::memory_order_relaxed);
+            for (size_t Bit = 0; Word != 0; ++Bit, Word >>= 1)
+            {
+                if (Word & 1) ReleasedDirtyTiles.push_back({Grid.GetTileX(WordIndex * 64 + Bit), Grid.GetTileY(WordIndex * 64 + Bit)});
+            }
+        }
+        Grid.ReleaseChunk(Slot);
+    }
+    for (const auto& [ChunkX, ChunkY] : MissingChunks)
+    {
+        Grid.AcquireChunk(ChunkX, ChunkY);
+    }
+    if (Grid.GetTileCapacity() > TileClaims.size()) GrowTileState();
+}
+
+bool Simulator::ResolveChunk(int32_t& ChunkX, int32_t& ChunkY) const
+{
+    if (Topology == EWorldTopology::Unbounded) return true;
+    const int32_t ChunkCountX = (Width + ChunkSize - 1) / ChunkSize;
+    const int32_t ChunkCountY = (Height + ChunkSize - 1) / ChunkSize;
+    if (Topology == EWorldTopology::Toroidal)
+    {
+        // The last chunk may be cut off by the border, the tile after the border is in chunk 0 either way.
+        ChunkX = WorldTopology<EWorldTopology::Toroidal>::Wrap(ChunkX, ChunkCountX);
+        ChunkY = WorldTopology<EWorldTopology::Toroidal>::Wrap(ChunkY, ChunkCountY);
+        return true;
+    }
+    return ChunkX >= 0 && ChunkX < ChunkCountX && ChunkY >= 0 && ChunkY < ChunkCountY;
 }
 
 void Simulator::Update()
 {
-    for (auto& Tile : Grid)
+    CELLULAR_SIMULATOR_PROFILE(Profiler.BeginTick(TickCount, ActiveIds.size()));
+    if (Lineage) Lineage->BeginTick(TickCount);
+    size_t StoreOrderBreaks = 0;
     {
-        Tile.SetCell(nullptr);
+        CELLULAR_SIMULATOR_PROFILE_PHASE(Profiler, ETickPhase::Decide);
+        StoreOrderBreaks = CollectActiveCellsByChunk();
+        UpdateChunkResidency();
+        // Every command spawns at most one cell, so the store never has to grow while commands run.
+        Cells.EnsureFreeSlots(ActiveIds.size());
+        Requests.resize(ActiveIds.size());
+        std::transform(std::execution::par, ActiveIds.begin(), ActiveIds.end(), Requests.begin(),
+            [this](CellId Id) -> ActionRequest { return {Id, Cells.DecideNextCommand(Id), NoTile}; });
     }
-    for (size_t i = 0; i < ActiveCellCount; ++i)
+    const size_t CellsBeforeExecute = ActiveIds.size();
+    if (Statistics) LastStatistics.OpcodeCounts.fill(0);
+
     {
-        Cell& cell = CellPool[i];
-        GetTile(cell.GetX(), cell.GetY())->SetCell(&cell);
+        CELLULAR_SIMULATOR_PROFILE_PHASE(Profiler, ETickPhase::Execute);
+        // The topology is picked once per tick, the passes and the commands resolve neighbours without checking it.
+        switch (Topology)
+        {
+            case EWorldTopology::Bounded: ExecuteCommands<EWorldTopology::Bounded>(); break;
+            case EWorldTopology::Unbounded: ExecuteCommands<EWorldTopology::Unbounded>(); break;
+            case EWorldTopology::Toroidal: ExecuteCommands<EWorldTopology::Toroidal>(); break;
+        }
     }
 
-    struct ActionRequest
     {
-        Cell* Agent;
-        size_t CommandNameHash;
-    };
+        CELLULAR_SIMULATOR_PROFILE_PHASE(Profiler, ETickPhase::EnergyDrain);
+        if (Statistics) LastStatistics.Births = ActiveIds.size() - CellsBeforeExecute;
+        DrainEnergy(CellsBeforeExecute);
+    }
+
+    {
+        CELLULAR_SIMULATOR_PROFILE_PHASE(Profiler, ETickPhase::RemoveDead);
+        RemoveDeadCells();
+    }
+    if (Statistics)
+    {
+        LastStatistics.Tick = TickCount;
+        Statistics->TakeEvents(LastStatistics);
+        Statistics->Submit(LastStatistics);
+    }
+    if (Lineage) Lineage->EndTick(TickCount);
+    ++TickCount;
+    const bool bCompactionDue = CompactionInterval > 0 && TickCount % CompactionInterval == 0;
+    // The order is only checked now and then, so a burst of births right after a compaction does not trigger the next one.
+    const bool bStoreScattered = CompactionThreshold > 0.0f && TickCount % CompactionCheckInterval == 0 &&
+        StoreOrderBreaks > CompactionThreshold * static_cast<float>(ActiveIds.size());
+    if (bCompactionDue || bStoreScattered)
+    {
+        CELLULAR_SIMULATOR_PROFILE_PHASE(Profiler, ETickPhase::Compact);
+        CompactCells();
+    }
+    CELLULAR_SIMULATOR_PROFILE(Profiler.EndTick());
+}
+
+void Simulator::CompactCells()
+{
+    // Store live cells in processing order, so that the cells of a chunk are neighbours in the store.
+    CollectActiveCellsByChunk();
+    Cells.Reorder(ActiveIds.data(), ActiveIds.size());
+    for (size_t i = 0; i < ActiveIds.size(); ++i)
+    {
+        const CellId Id = static_cast<CellId>(i);
+        ActiveIds[i] = Id;
+        Grid[Grid.FindTile(Cells.GetX(Id), Cells.GetY(Id))].SetCellId(Id);
+    }
+}
+
+namespace
+{
+uint32_t CollectChunkCells(const GridTile* Tiles, CellId* Out)
+{
+    uint32_t Count = 0;
+    for (size_t i = 0; i < ChunkedGrid::TilesPerChunk; ++i)
+    {
+        const CellId Id = Tiles[i].GetCellId();
+        Out[Count] = Id;
+        Count += Id != InvalidCellId;
+    }
+    return Count;
+}
+} // namespace
+
+size_t Simulator::CollectActiveCellsByChunk()
+{
+    // The processing order is rebuilt from the grid, which is a sequential scan, instead of sorting the ids,
+    // which would read the position of every cell from wherever its slot happens to be. The order only
+    // depends on where the cells are, so it is deterministic and survives snapshots.
+    // Ids are written unconditionally and kept only for occupied tiles, so the scan does not branch on the density.
+    // The tiles of a chunk are contiguous and the chunks are visited by position, not by slot.
+    ActiveIds.resize(Grid.GetTileCapacity());
+    ChunkPopulation.assign(Grid.GetChunkSlotCount(), 0);
+    CellId* Out = ActiveIds.data();
+    size_t Count = 0;
+    Grid.ForEachChunk([&](uint32_t Slot) {
+        const uint32_t Population = CollectChunkCells(&Grid[ChunkedGrid::GetFirstTile(Slot)], Out + Count);
+        ChunkPopulation[Slot] = Population;
+        Count += Population;
+    });
+    ActiveIds.resize(Count);
+
+    size_t OrderBreaks = 0;
+    for (size_t i = 1; i < Count; ++i)
+    {
+        OrderBreaks += ActiveIds[i] < ActiveIds[i - 1];
+    }
+    return OrderBreaks;
+}
+
+namespace
+{
+/**
+ * Drains a range of slots and returns the energy left in it and the number of slots that still hold energy.
+ * The sums run over separate lanes and the survivors are counted in a loop of their own, which keeps both passes
+ * vectorizable. Every short block is added up in double precision.
+ */
+std::pair<double, uint64_t> DrainAndSum(float* Energy, size_t Count)
+{
+    constexpr size_t Lanes = 8;
+    constexpr size_t BlockSize = 256;
+    double Total = 0.0;
+    uint64_t Survivors = 0;
+    for (size_t Block = 0; Block < Count; Block += BlockSize)
+    {
+        float* Slots = Energy + Block;
+        const size_t BlockCount = std::min(BlockSize, Count - Block);
+        const size_t LaneCount = BlockCount - BlockCount % Lanes;
+        float LaneEnergy[Lanes] = {};
+        for (size_t i = 0; i < LaneCount; i += Lanes)
+        {
+            for (size_t Lane = 0; Lane < Lanes; ++Lane)
+            {
+                Slots[i + Lane] = std::max(0.0f, Slots[i + Lane] - 10.0f);
+                LaneEnergy[Lane] += Slots[i + Lane];
+            }
+        }
+        for (size_t i = LaneCount; i < BlockCount; ++i)
+        {
+            Slots[i] = std::max(0.0f, Slots[i] - 10.0f);
+            LaneEnergy[0] += Slots[i];
+        }
+        // The block was just written, so counting it again reads from cache.
+        uint32_t BlockSurvivors = 0;
+        for (size_t i = 0; i < BlockCount; ++i)
+        {
+            BlockSurvivors += Slots[i] > 0.0f;
+        }
+        for (const float LaneSum : LaneEnergy)
+        {
+            Total += LaneSum;
+        }
+        Survivors += BlockSurvivors;
+    }
+    return {Total, Survivors};
+}
+} // namespace
+
+void Simulator::DrainEnergy(size_t CellsBeforeExecute)
+{
+    // Only cells that were alive before the commands ran pay for the tick. The newborns, appended to ActiveIds
+    // by the commands, are few, so their energy is set aside and put back rather than splitting the contiguous pass.
+    NewbornEnergy.resize(ActiveIds.size() - CellsBeforeExecute);
+    for (size_t i = 0; i < NewbornEnergy.size(); ++i)
+    {
+        NewbornEnergy[i] = Cells.GetEnergy(ActiveIds[CellsBeforeExecute + i]);
+    }
+
+    float* Energy = Cells.GetEnergyData();
+    const size_t SlotCount = Cells.GetSlotCount();
+    if (!Statistics)
+    {
+        // Free slots hold zero energy, so draining the whole slot range is harmless and keeps the pass contiguous.
+        std::transform(std::execution::par_unseq, Energy, Energy + SlotCount, Energy, [](float Value) { return std::max(0.0f, Value - 10.0f); });
+        RestoreNewbornEnergy(CellsBeforeExecute);
+        return;
+    }
+
+    // The drain also sums the energy and counts the survivors of every slice. The slices are fixed and summed in order,
+    // so the total does not depend on the number of threads.
+    DrainPartials.resize((SlotCount + DrainSliceSize - 1) / DrainSliceSize);
+    std::for_each(std::execution::par, DrainPartials.begin(), DrainPartials.end(), [&](std::pair<double, uint64_t>& Partial) {
+        const size_t First = static_cast<size_t>(&Partial - DrainPartials.data()) * DrainSliceSize;
+        Partial = DrainAndSum(Energy + First, std::min(DrainSliceSize, SlotCount - First));
+    });
+    LastStatistics.TotalEnergy = 0.0;
+    LastStatistics.Population = 0;
+    for (const auto& [SliceEnergy, SliceSurvivors] : DrainPartials)
+    {
+        LastStatistics.TotalEnergy += SliceEnergy;
+        LastStatistics.Population += SliceSurvivors;
+    }
+    for (size_t i = 0; i < NewbornEnergy.size(); ++i)
+    {
+        const float Drained = Energy[ActiveIds[CellsBeforeExecute + i]];
+        LastStatistics.TotalEnergy += static_cast<double>(NewbornEnergy[i]) - static_cast<double>(Drained);
+        LastStatistics.Population += static_cast<uint64_t>(NewbornEnergy[i] > 0.0f) - static_cast<uint64_t>(Drained > 0.0f);
+    }
+    RestoreNewbornEnergy(CellsBeforeExecute);
+    // Only live cells can hold energy, so every other cell of the tick dies in RemoveDeadCells.
+    LastStatistics.Deaths = ActiveIds.size() - LastStatistics.Population;
+}
+
+void Simulator::RestoreNewbornEnergy(size_t CellsBeforeExecute)
+{
+    for (size_t i = 0; i < NewbornEnergy.size(); ++i)
+    {
+        Cells.SetEnergy(ActiveIds[CellsBeforeExecute + i], NewbornEnergy[i]);
+    }
+}
 
-    auto FirstCellIt = CellPool.begin();
-    auto LastCellIt = CellPool.begin() + ActiveCellCount;
+void Simulator::RemoveDeadCells()
+{
+    // Dead cells keep their slot until it is reused, so only their tiles and the id list are touched.
+    const float* Energy = Cells.GetEnergyData();
+    const auto FirstDead = std::remove_if(ActiveIds.begin(), ActiveIds.end(), [this, Energy](CellId Id) {
+        if (Energy[Id] > 0.0f) return false;
+        const size_t TileIndex = Grid.FindTile(Cells.GetX(Id), Cells.GetY(Id));
+        Grid[TileIndex].SetCellId(InvalidCellId);
+        MarkTileIndexDirty(TileIndex);
+        Cells.Free(Id);
+        return true;
+    });
+    CELLULAR_SIMULATOR_PROFILE(Profiler.AddDeaths(static_cast<uint64_t>(ActiveIds.end() - FirstDead)));
+    ActiveIds.erase(FirstDead, ActiveIds.end());
+}
 
-    std::vector<ActionRequest> Requests(ActiveCellCount);
-    std::transform(std::execution::par, CellPool.begin(), LastCellIt, Requests.begin(),
-        [](Cell& Agent) -> ActionRequest { return {&Agent, Agent.DecideNextCommand()}; });
+template <EWorldTopology TTopology>
+void Simulator::ExecuteCommands()
+{
+    if (ExecutionMode == EExecutionMode::Parallel)
+    {
+        ExecuteParallel<TTopology>();
+    }
+    else
+    {
+        ExecuteSerial<TTopology>();
+    }
+}
 
+template <EWorldTopology TTopology>
+void Simulator::ExecuteSerial()
+{
+    const CommandManager::DispatchTable& Commands = CommandManager::GetDispatchTable();
+    const WorldAccessor<TTopology> World(*this);
+    uint64_t* OpcodeCounts = Statistics ? LastStatistics.OpcodeCounts.data() : nullptr;
     for (const auto& Request : Requests)
     {
-        Cell* Agent = Request.Agent;
-        Command* Cmd = CommandManager::GetCommand(Request.CommandNameHash);
+        if (OpcodeCounts) ++OpcodeCounts[Request.Gene];
+        Command* Cmd = Commands[Request.Gene];
         if (Cmd)
         {
-            Cmd->Execute(*this, *Agent);
+            Cell Agent(&Cells, Request.Agent);
+            Cmd->ExecuteIn(World, Agent);
         }
     }
+}
+
+template <EWorldTopology TTopology>
+void Simulator::ExecuteParallel()
+{
+    const CommandManager::DispatchTable& Commands = CommandManager::GetDispatchTable();
+    const WorldAccessor<TTopology> World(*this);
+    ActionRequest* const First = Requests.data();
+    auto GetTargetOf = [&Commands](const ActionRequest& Request) {
+        const Command* Cmd = Commands[Request.Gene];
+        return Cmd ? Cmd->GetTarget() : ECommandTarget::Self;
+    };
+    auto ReleaseClaims = [this](const ActionRequest& Request) {
+        if (Request.TargetTile == NoTile) return;
+        TileClaims[Request.TargetTile].store(UnclaimedTile, std::memory_order_relaxed);
+        TileClaims[Grid.FindTile(Cells.GetX(Request.Agent), Cells.GetY(Request.Agent))].store(UnclaimedTile, std::memory_order_relaxed);
+    };
 
-    std::for_each(std::execution::par, FirstCellIt, LastCellIt, [](Cell& Agent) { Agent.ConsumeEnergy(10.0f); });
+    // Stage 1: commands that touch only the agent or the empty tile in front of it.
+    // Every empty tile goes to the first agent in cell order that wants it. Commands draw from
+    // per-cell counter-based streams, so the order in which the threads run them does not matter.
+    std::for_each(std::execution::par, Requests.begin(), Requests.end(), [&](ActionRequest& Request) {
+        if (GetTargetOf(Request) != ECommandTarget::EmptyForward) return;
+        Request.TargetTile = FindTargetTile<TTopology>(Request.Agent, ECommandTarget::EmptyForward);
+        if (Request.TargetTile != NoTile) ClaimTile(Request.TargetTile, static_cast<uint32_t>(&Request - First));
+    });
 
-    for (size_t i = 0; i < ActiveCellCount; ++i)
+    // Agents are grouped by command, so every command runs over its whole group in a row
+    // instead of interleaving virtual calls to all commands in cell order.
+    BucketRequestsByOpcode();
+    if (Statistics)
     {
-        if (CellPool[i].GetEnergy() <= 0.0f)
+        for (size_t Gene = 0; Gene < CommandManager::MaxCommands; ++Gene)
         {
-            CellPool[i].SetInObjectPool(true);
+            LastStatistics.OpcodeCounts[Gene] = BucketOffsets[Gene + 1] - BucketOffsets[Gene];
         }
     }
-    auto FirstDead = std::partition(CellPool.begin(), CellPool.begin() + ActiveCellCount, [](const Cell& c) { return c.IsAlive(); });
-    ActiveCellCount = std::distance(CellPool.begin(), FirstDead);
+    bDeferSpawnCount = true;
+    PendingSpawnCount.store(0);
+    ExecuteBatches(World, [this](ECommandTarget Target, uint32_t RequestIndex) {
+        if (Target == ECommandTarget::OccupiedForward) return false;
+        return Target == ECommandTarget::Self || IsClaimedBy(Requests[RequestIndex].TargetTile, RequestIndex);
+    });
+    bDeferSpawnCount = false;
+    CommitParallelSpawns();
+
+    std::for_each(std::execution::par, Requests.begin(), Requests.end(), [&](ActionRequest& Request) {
+        if (Request.TargetTile == NoTile) return;
+        TileClaims[Request.TargetTile].store(UnclaimedTile, std::memory_order_relaxed);
+        Request.TargetTile = NoTile;
+    });
+
+    // Stage 2: commands that act on the cell in front of the agent. An agent has to win both its own
+    // tile and the target tile, so a cell is never eaten and eating at the same time.
+    std::for_each(std::execution::par, Requests.begin(), Requests.end(), [&](ActionRequest& Request) {
+        if (GetTargetOf(Request) != ECommandTarget::OccupiedForward) return;
+        Request.TargetTile = FindTargetTile<TTopology>(Request.Agent, ECommandTarget::OccupiedForward);
+        if (Request.TargetTile == NoTile) return;
+        const uint32_t RequestIndex = static_cast<uint32_t>(&Request - First);
+        ClaimTile(Request.TargetTile, RequestIndex);
+        ClaimTile(Grid.FindTile(Cells.GetX(Request.Agent), Cells.GetY(Request.Agent)), RequestIndex);
+    });
+
+    ExecuteBatches(World, [this](ECommandTarget Target, uint32_t RequestIndex) {
+        const ActionRequest& Request = Requests[RequestIndex];
+        if (Target != ECommandTarget::OccupiedForward || Request.TargetTile == NoTile) return false;
+        const size_t OwnTile = Grid.FindTile(Cells.GetX(Request.Agent), Cells.GetY(Request.Agent));
+        return IsClaimedBy(Request.TargetTile, RequestIndex) && IsClaimedBy(OwnTile, RequestIndex);
+    });
+
+    std::for_each(std::execution::par, Requests.begin(), Requests.end(), ReleaseClaims);
 }
 
-void Simulator::Randomize(float Density)
+void Simulator::BucketRequestsByOpcode()
 {
-    for (auto& Tile : Grid)
+    // A counting sort keeps cell order inside every bucket.
+    BucketOffsets.assign(CommandManager::MaxCommands + 1, 0);
+    for (const ActionRequest& Request : Requests)
     {
-        Tile.SetCell(nullptr);
+        ++BucketOffsets[Request.Gene + 1];
     }
-    const std::vector<size_t> AvailableCommands = CommandManager::GetRegisteredCommandNamesHashes();
-    if (AvailableCommands.empty()) return;
-    std::mt19937 Rng = GetRNG();
-    std::uniform_real_distribution<float> Dist(0.0f, 1.0f);
-    std::uniform_int_distribution<size_t> CommandIndexDist(0, AvailableCommands.size() - 1);
-    for (int32_t Y = 0; Y < Height; ++Y)
+    std::partial_sum(BucketOffsets.begin(), BucketOffsets.end(), BucketOffsets.begin());
+    BucketCursors.assign(BucketOffsets.begin(), BucketOffsets.end() - 1);
+    BucketedRequests.resize(Requests.size());
+    BucketedAgents.resize(Requests.size());
+    for (size_t i = 0; i < Requests.size(); ++i)
     {
-        for (int32_t X = 0; X < Width; ++X)
+        const size_t Position = BucketCursors[Requests[i].Gene]++;
+        BucketedRequests[Position] = static_cast<uint32_t>(i);
+        BucketedAgents[Position] = Requests[i].Agent;
+    }
+}
+
+template <EWorldTopology TTopology, typename TFilter>
+void Simulator::ExecuteBatches(const WorldAccessor<TTopology>& World, TFilter&& ShouldRun)
+{
+    const CommandManager::DispatchTable& Commands = CommandManager::GetDispatchTable();
+    BatchAgents.resize(BucketedAgents.size());
+    for (size_t Gene = 0; Gene < CommandManager::MaxCommands; ++Gene)
+    {
+        const size_t Begin = BucketOffsets[Gene];
+        const size_t End = BucketOffsets[Gene + 1];
+        Command* Cmd = Commands[Gene];
+        if (Begin == End || !Cmd) continue;
+        const ECommandTarget Target = Cmd->GetTarget();
+        // Agents are filtered in cell order, so a batch does not depend on the number of threads.
+        size_t Count = 0;
+        for (size_t i = Begin; i < End; ++i)
         {
-            if (Dist(Rng) > Density) continue;
-            std::vector<std::size_t> RandomGenome;
-            RandomGenome.reserve(GenomeLength);
-            for (int i = 0; i < GenomeLength; ++i)
-            {
-                RandomGenome.push_back(AvailableCommands[CommandIndexDist(Rng)]);
-            }
-            SpawnCell(X, Y, EDirection::North, std::move(RandomGenome), 50);
+            BatchAgents[Begin + Count] = BucketedAgents[i];
+            Count += ShouldRun(Target, BucketedRequests[i]);
+        }
+        ExecuteBatch(*Cmd, World, &BatchAgents[Begin], Count);
+    }
+}
+
+template <EWorldTopology TTopology>
+void Simulator::ExecuteBatch(Command& Cmd, const WorldAccessor<TTopology>& World, const CellId* Agents, size_t Count)
+{
+    if (Count == 0) return;
+    // Slices let the threads share a large batch without paying the parallel algorithm overhead per agent.
+    BatchSlices.resize((Count + BatchSliceSize - 1) / BatchSliceSize);
+    std::iota(BatchSlices.begin(), BatchSlices.end(), size_t{0});
+    std::for_each(std::execution::par, BatchSlices.begin(), BatchSlices.end(), [&](size_t Slice) {
+        const size_t First = Slice * BatchSliceSize;
+        Cmd.ExecuteBatchIn(World, {Agents + First, std::min(BatchSliceSize, Count - First)});
+    });
+}
+
+template <EWorldTopology TTopology>
+size_t Simulator::FindTargetTile(CellId Agent, ECommandTarget Target) const
+{
+    int32_t NextX;
+    int32_t NextY;
+    GetForwardXY(Cells.GetDirection(Agent), NextX, NextY, Cells.GetX(Agent), Cells.GetY(Agent));
+    size_t TileIndex;
+    if (!ResolveTile<TTopology>(NextX, NextY, TileIndex) || TileIndex == NoTile) return NoTile;
+    const bool bWantsEmpty = Target == ECommandTarget::EmptyForward;
+    return Grid[TileIndex].HasCell() != bWantsEmpty ? TileIndex : NoTile;
+}
+
+void Simulator::ClaimTile(size_t TileIndex, uint32_t RequestIndex)
+{
+    std::atomic<uint32_t>& Claim = TileClaims[TileIndex];
+    uint32_t Current = Claim.load(std::memory_order_relaxed);
+    while (RequestIndex < Current && !Claim.compare_exchange_weak(Current, RequestIndex, std::memory_order_relaxed))
+    {
+    }
+}
+
+bool Simulator::IsClaimedBy(size_t TileIndex, uint32_t RequestIndex) const
+{
+    return TileIndex != NoTile && TileClaims[TileIndex].load(std::memory_order_relaxed) == RequestIndex;
+}
+
+void Simulator::CommitParallelSpawns()
+{
+    const size_t SpawnCount = std::min(Cells.GetFreeCount(), PendingSpawnCount.load());
+    if (SpawnCount == 0) return;
+
+    SpawnSlots.resize(SpawnCount);
+    for (size_t i = 0; i < SpawnCount; ++i)
+    {
+        SpawnSlots[i] = Cells.PeekAllocation(i);
+    }
+    Cells.CommitAllocations(SpawnCount);
+
+    // Slots were handed out in whatever order the threads reached SpawnCell. Reorder the newborns
+    // by position so that their ids, and therefore the next tick, do not depend on scheduling.
+    SpawnOrder.resize(SpawnCount);
+    for (size_t i = 0; i < SpawnCount; ++i)
+    {
+        SpawnOrder[i] = {GetPositionKey(Cells.GetX(SpawnSlots[i]), Cells.GetY(SpawnSlots[i])), static_cast<CellId>(i)};
+    }
+    std::sort(SpawnOrder.begin(), SpawnOrder.end());
+
+    SpawnDestination.resize(SpawnCount);
+    for (size_t i = 0; i < SpawnCount; ++i)
+    {
+        SpawnDestination[SpawnOrder[i].second] = static_cast<uint32_t>(i);
+    }
+    for (size_t i = 0; i < SpawnCount; ++i)
+    {
+        while (SpawnDestination[i] != i)
+        {
+            const size_t j = SpawnDestination[i];
+            Cells.Swap(SpawnSlots[i], SpawnSlots[j]);
+            std::swap(SpawnDestination[i], SpawnDestination[j]);
         }
     }
+    for (size_t i = 0; i < SpawnCount; ++i)
+    {
+        Grid[Grid.FindTile(Cells.GetX(SpawnSlots[i]), Cells.GetY(SpawnSlots[i]))].SetCellId(SpawnSlots[i]);
+        ActiveIds.push_back(SpawnSlots[i]);
+    }
+}
+
+void Simulator::Randomize(float Density)
+{
+    Clear();
+    PopulateRegion(0, 0, Width, Height, Density);
+}
+
+void Simulator::Clear()
+{
+    Grid.Reset((Width + ChunkSize - 1) / ChunkSize, (Height + ChunkSize - 1) / ChunkSize);
+    ReleasedDirtyTiles.clear();
+    MarkAllTilesDirty();
+    Cells.Clear();
+    ActiveIds.clear();
+}
+
+void Simulator::PopulateRegion(int32_t X, int32_t Y, int32_t RegionWidth, int32_t RegionHeight, float Density)
+{
+    const size_t CommandCount = CommandManager::GetRegisteredCommandCount();
+    if (CommandCount == 0) return;
+    if (Topology != EWorldTopology::Unbounded)
+    {
+        const int32_t EndX = std::min(X + RegionWidth, Width);
+        const int32_t EndY = std::min(Y + RegionHeight, Height);
+        X = std::max(X, 0);
+        Y = std::max(Y, 0);
+        RegionWidth = std::max(0, EndX - X);
+        RegionHeight = std::max(0, EndY - Y);
+    }
+    const uint64_t Randomization = RandomizeCount++;
+    std::vector<Opcode> RandomGenome(GenomeLength);
+    // Cells are created in processing order, so a fresh world starts out compact.
+    ForEachTileByChunk(X, Y, RegionWidth, RegionHeight, [&](int32_t TileX, int32_t TileY) {
+        if (!IsTileValidAndEmpty(TileX, TileY)) return;
+        CounterRng Rng(Seed, ERandomStream::World, Randomization, GetPositionKey(TileX, TileY));
+        if (Rng.NextFloat() > Density) return;
+        for (Opcode& Gene : RandomGenome)
+        {
+            Gene = static_cast<Opcode>(Rng.NextBelow(static_cast<uint32_t>(CommandCount)));
+        }
+        SpawnCell(TileX, TileY, EDirection::North, {RandomGenome.data(), RandomGenome.size()}, 50);
+    });
 }
 
 GridTile* Simulator::GetTile(int32_t X, int32_t Y)
 {
-    if (X < 0 || X >= Width || Y < 0 || Y >= Height) return nullptr;
-    return &Grid[static_cast<size_t>(Y) * Width + X];
+    size_t TileIndex;
+    if (!ResolveTile(X, Y, TileIndex) || TileIndex == NoTile) return nullptr;
+    return &Grid[TileIndex];
 }
 
 int32_t Simulator::GetWidth() const
@@ -107,41 +651,258 @@ int32_t Simulator::GetHeight() const
 
 bool Simulator::IsTileValidAndEmpty(int32_t X, int32_t Y) const
 {
-    if (X < 0 || X >= Width || Y < 0 || Y >= Height) return false;
-    const GridTile* Tile = &Grid[static_cast<size_t>(Y) * Width + X];
-    return Tile->GetCell() == nullptr;
+    size_t TileIndex;
+    return ResolveTile(X, Y, TileIndex) && (TileIndex == NoTile || !Grid[TileIndex].HasCell());
 }
 
-void Simulator::MoveCell(Cell* Agent, int32_t NewX, int32_t NewY)
+Cell Simulator::GetCell(CellId Id)
 {
-    if (!IsTileValidAndEmpty(NewX, NewY)) return;
+    if (!Cells.IsLive(Id)) return {};
+    return {&Cells, Id};
+}
 
-    GridTile* OldTile = &Grid[static_cast<size_t>(Agent->GetY()) * Width + Agent->GetX()];
-    OldTile->SetCell(nullptr);
+void Simulator::CopyRegionColors(int32_t X, int32_t Y, int32_t RegionWidth, int32_t RegionHeight, int32_t Step, CellColor* OutPixels, CellColor EmptyColor) const
+{
+    const int32_t OutWidth = (RegionWidth + Step - 1) / Step;
+    const int32_t OutHeight = (RegionHeight + Step - 1) / Step;
+    std::vector<int32_t> Rows(OutHeight);
+    std::iota(Rows.begin(), Rows.end(), 0);
+    std::for_each(std::execution::par, Rows.begin(), Rows.end(), [&](int32_t OutY) {
+        CellColor* OutRow = OutPixels + static_cast<size_t>(OutY) * OutWidth;
+        const int32_t FirstY = Y + OutY * Step;
+        const int32_t LastY = std::min(FirstY + Step, Y + RegionHeight);
+        if (Step == 1)
+        {
+            for (int32_t TileX = X; TileX < X + RegionWidth;)
+            {
+                int32_t RunEndX = X + RegionWidth;
+                const GridTile* Run = FindTileRun(TileX, FirstY, RunEndX);
+                for (; TileX < RunEndX; ++TileX)
+                {
+                    const GridTile* Tile = Run ? Run++ : nullptr;
+                    OutRow[TileX - X] = Tile && Tile->HasCell() ? Cells.GetColor(Tile->GetCellId()) : EmptyColor;
+                }
+            }
+            return;
+        }
+        for (int32_t OutX = 0; OutX < OutWidth; ++OutX)
+        {
+            const int32_t FirstX = X + OutX * Step;
+            const int32_t LastX = std::min(FirstX + Step, X + RegionWidth);
+            OutRow[OutX] = GetRegionColor(FirstX, FirstY, LastX - FirstX, LastY - FirstY, EmptyColor);
+        }
+    });
+}
 
-    GridTile* NewTile = &Grid[static_cast<size_t>(NewY) * Width + NewX];
-    NewTile->SetCell(Agent);
-    Agent->SetX(NewX);
-    Agent->SetY(NewY);
+CellColor Simulator::GetRegionColor(int32_t X, int32_t Y, int32_t RegionWidth, int32_t RegionHeight, CellColor EmptyColor) const
+{
+    uint32_t TotalR = 0, TotalG = 0, TotalB = 0;
+    for (int32_t TileY = Y; TileY < Y + RegionHeight; ++TileY)
+    {
+        for (int32_t TileX = X; TileX < X + RegionWidth;)
+        {
+            int32_t RunEndX = X + RegionWidth;
+            const GridTile* Run = FindTileRun(TileX, TileY, RunEndX);
+            for (; TileX < RunEndX; ++TileX)
+            {
+                const GridTile* Tile = Run ? Run++ : nullptr;
+                const CellColor Color = Tile && Tile->HasCell() ? Cells.GetColor(Tile->GetCellId()) : EmptyColor;
+                TotalR += Color.R;
+                TotalG += Color.G;
+                TotalB += Color.B;
+            }
+        }
+    }
+    const uint32_t Count = static_cast<uint32_t>(RegionWidth * RegionHeight);
+    return {static_cast<uint8_t>(TotalR / Count), static_cast<uint8_t>(TotalG / Count), static_cast<uint8_t>(TotalB / Count), 255};
+}
+
+const GridTile* Simulator::FindTileRun(int32_t X, int32_t Y, int32_t& InOutEndX) const
+{
+    // The tiles of a chunk row are contiguous, so a run ends at the chunk border at the latest.
+    InOutEndX = std::min(InOutEndX, (ChunkedGrid::ToChunkCoordinate(X) + 1) * ChunkSize);
+    if (!IsInsideWorld(X, Y)) return nullptr;
+    const size_t TileIndex = Grid.FindTile(X, Y);
+    return TileIndex != NoTile ? &Grid[TileIndex] : nullptr;
+}
+
+void Simulator::SetDirtyTracking(bool bEnabled)
+{
+    bTrackDirtyTiles = bEnabled;
+    for (auto& Word : DirtyBits)
+    {
+        Word.store(0, std::memory_order_relaxed);
+    }
+    ReleasedDirtyTiles.clear();
+    bAnyTileDirty.store(false, std::memory_order_relaxed);
+    MarkAllTilesDirty();
+}
+
+void Simulator::MarkTileDirty(int32_t X, int32_t Y)
+{
+    size_t TileIndex;
+    if (ResolveTile(X, Y, TileIndex) && TileIndex != NoTile) MarkTileIndexDirty(TileIndex);
+}
+
+bool Simulator::TakeDirtyTiles(std::vector<TilePosition>& OutTiles)
+{
+    OutTiles.clear();
+    const bool bAllDirty = bAllTilesDirty.exchange(false, std::memory_order_relaxed);
+    if (!bAnyTileDirty.exchange(false, std::memory_order_relaxed)) return bAllDirty;
+    if (!bAllDirty) OutTiles.swap(ReleasedDirtyTiles);
+    ReleasedDirtyTiles.clear();
+    for (size_t WordIndex = 0; WordIndex < DirtyBits.size(); ++WordIndex)
+    {
+        uint64_t Word = DirtyBits[WordIndex].exchange(0, std::memory_order_relaxed);
+        if (bAllDirty) continue;
+        for (size_t Bit = 0; Word != 0; ++Bit, Word >>= 1)
+        {
+            if (Word & 1) OutTiles.push_back({Grid.GetTileX(WordIndex * 64 + Bit), Grid.GetTileY(WordIndex * 64 + Bit)});
+        }
+    }
+    return bAllDirty;
+}
+
+void Simulator::MoveCell(const Cell& Agent, int32_t NewX, int32_t NewY)
+{
+    size_t NewTileIndex;
+    if (ResolveTile(NewX, NewY, NewTileIndex)) MoveCellToTile(Agent, NewX, NewY, NewTileIndex);
+}
+
+void Simulator::MoveCellToTile(const Cell& Agent, int32_t NewX, int32_t NewY, size_t NewTileIndex)
+{
+    if (NewTileIndex == NoTile)
+    {
+        NewTileIndex = AcquireTile(NewX, NewY);
+    }
+    else if (Grid[NewTileIndex].HasCell())
+    {
+        return;
+    }
+
+    const size_t OldTileIndex = Grid.FindTile(Agent.GetX(), Agent.GetY());
+    Grid[OldTileIndex].SetCellId(InvalidCellId);
+    MarkTileIndexDirty(OldTileIndex);
+
+    Grid[NewTileIndex].SetCellId(Agent.GetId());
+    MarkTileIndexDirty(NewTileIndex);
+    Cells.SetX(Agent.GetId(), NewX);
+    Cells.SetY(Agent.GetId(), NewY);
+    if (Statistics) Statistics->AddMove();
+    CELLULAR_SIMULATOR_PROFILE(Profiler.AddMoves(1));
+}
+
+Cell Simulator::SpawnCell(int32_t X, int32_t Y, EDirection Direction, GenomeView Genome, float Energy)
+{
+    size_t TileIndex;
+    if (!ResolveTile(X, Y, TileIndex)) return {};
+    return SpawnCellWithGenome(X, Y, TileIndex, Direction, Genome, Energy);
+}
+
+Cell Simulator::SpawnCell(int32_t X, int32_t Y, EDirection Direction, GenomeId Genome, float Energy)
+{
+    size_t TileIndex;
+    if (!ResolveTile(X, Y, TileIndex)) return {};
+    return SpawnCellAtTile(X, Y, TileIndex, Direction, Genome, Energy);
+}
+
+Cell Simulator::SpawnCellAtTile(int32_t X, int32_t Y, size_t TileIndex, EDirection Direction, GenomeId Genome, float Energy)
+{
+    return SpawnCellWithGenome(X, Y, TileIndex, Direction, Genome, Energy);
+}
+
+template <typename TGenome>
+Cell Simulator::SpawnCellWithGenome(int32_t X, int32_t Y, size_t TileIndex, EDirection Direction, TGenome Genome, float Energy)
+{
+    if (TileIndex != NoTile && Grid[TileIndex].HasCell()) return {};
+    if (!bDeferSpawnCount && Cells.GetFreeCount() == 0) Cells.EnsureFreeSlots(1);
+    // While commands run in parallel, slots are only reserved here and taken in CommitParallelSpawns.
+    const CellId NewId = bDeferSpawnCount ? Cells.PeekAllocation(PendingSpawnCount.fetch_add(1, std::memory_order_relaxed)) : Cells.Allocate();
+    if (NewId == InvalidCellId) return {};
+    if (TileIndex == NoTile) TileIndex = AcquireTile(X, Y);
+    Grid[TileIndex].SetCellId(NewId);
+    MarkTileIndexDirty(TileIndex);
+    Cells.Initialize(NewId, X, Y, Direction, Genome, std::max(0.0f, std::min(CellStore::MaxEnergy, Energy)));
+    if (!bDeferSpawnCount) ActiveIds.push_back(NewId);
+    CELLULAR_SIMULATOR_PROFILE(Profiler.AddSpawns(1));
+    return {&Cells, NewId};
+}
+
+void Simulator::GetGenotypeCensus(std::vector<GenotypeCount>& OutCensus, size_t MaxCount) const
+{
+    const GenomeTable& Genomes = Cells.GetGenomeTable();
+    OutCensus.clear();
+    OutCensus.reserve(Genomes.GetGenomeCount());
+    Genomes.ForEachGenome([&OutCensus, &Genomes](GenomeId Genome) { OutCensus.push_back({Genome, Genomes.GetReferenceCount(Genome)}); });
+
+    const auto MoreCommon = [&Genomes](const GenotypeCount& A, const GenotypeCount& B) {
+        if (A.Population != B.Population) return A.Population > B.Population;
+        const GenomeView GenesA = Genomes.GetGenes(A.Genome);
+        const GenomeView GenesB = Genomes.GetGenes(B.Genome);
+        return std::lexicographical_compare(GenesA.begin(), GenesA.end(), GenesB.begin(), GenesB.end());
+    };
+    if (MaxCount > 0 && MaxCount < OutCensus.size())
+    {
+        std::partial_sort(OutCensus.begin(), OutCensus.begin() + static_cast<ptrdiff_t>(MaxCount), OutCensus.end(), MoreCommon);
+        OutCensus.resize(MaxCount);
+    }
+    else
+    {
+        std::sort(OutCensus.begin(), OutCensus.end(), MoreCommon);
+    }
+}
+
+bool Simulator::StartLineageRecording(const std::string& Path, size_t MaxRetainedAncestors)
+{
+    StopLineageRecording();
+    auto Recorder = std::make_unique<LineageRecorder>();
+    if (!Recorder->Open(Path, static_cast<size_t>(GenomeLength), MaxRetainedAncestors)) return false;
+
+    GenomeTable& Genomes = Cells.GetGenomeTable();
+    Recorder->BeginTick(TickCount);
+    Genomes.ForEachGenome([&Recorder, &Genomes](GenomeId Genome) {
+        Recorder->OnGenomeAdded(Genome, Genomes.GetGenes(Genome), InvalidGenomeId, 0, 0, true);
+    });
+    Recorder->EndTick(TickCount);
+    Lineage = std::move(Recorder);
+    Genomes.SetLineageRecorder(Lineage.get());
+    return true;
+}
+
+bool Simulator::StopLineageRecording()
+{
+    if (!Lineage) return true;
+    Cells.GetGenomeTable().SetLineageRecorder(nullptr);
+    const bool bWritten = Lineage->Close();
+    Lineage.reset();
+    return bWritten;
+}
+
+bool Simulator::StartStatisticsRecording(const std::string& Path)
+{
+    StopStatisticsRecording();
+    auto Recorder = std::make_unique<StatisticsRecorder>();
+    if (!Recorder->Open(Path)) return false;
+    LastStatistics = {};
+    Statistics = std::move(Recorder);
+    return true;
 }
 
-Cell* Simulator::SpawnCell(int32_t X, int32_t Y, EDirection Direction, std::vector<size_t> Genome, float Energy)
+bool Simulator::StopStatisticsRecording()
 {
-    if (!IsTileValidAndEmpty(X, Y) || ActiveCellCount >= CellPool.size()) return nullptr;
-    Cell& NewCell = CellPool[ActiveCellCount];
-    GetTile(X, Y)->SetCell(&NewCell);
-    NewCell.Initialize(X, Y, Direction, std::move(Genome), Energy, false);
-    ++ActiveCellCount;
-    return &NewCell;
+    if (!Statistics) return true;
+    const bool bWritten = Statistics->Close();
+    Statistics.reset();
+    return bWritten;
 }
 
-std::mt19937& Simulator::GetRNG()
+void Simulator::SetSeed(uint64_t InSeed)
 {
-    return RandomGenerator;
+    Seed = InSeed;
 }
 
-Cell* Simulator::GetActiveCellByIndex(size_t Index)
+Cell Simulator::GetActiveCellByIndex(size_t Index)
 {
-    if (Index >= ActiveCellCount) return nullptr;
-    return &CellPool[Index];
+    if (Index >= ActiveIds.size()) return {};
+    return {&Cells, ActiveIds[Index]};
 }
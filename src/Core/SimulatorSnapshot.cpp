@@ -0,0 +1,299 @@
+#include "CellularSimulator/Core/Simulator.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "CellularSimulator/Core/MappedFile.h"
+
+using namespace CellularSimulator::Core;
+
+/*
+ * Snapshot layout, all values in host byte order (the header records it):
+ *
+ *   SnapshotHeader
+ *   OpcodeCount x { uint16_t NameLength; char Name[NameLength]; }
+ *   CellId   FreeSlots[FreeCount]            free list, the next slot to be reused last
+ *   CellId   Ids[CellCount]                  live cells in processing order
+ *   int32_t  X[CellCount]
+ *   int32_t  Y[CellCount]
+ *   uint8_t  Direction[CellCount]
+ *   float    Energy[CellCount]
+ *   uint16_t GenomePointer[CellCount]
+ *   uint8_t  Genomes[CellCount * GenomeLength]
+ *
+ * Every property is a packed array so loading is a sequence of bulk copies out of the mapping.
+ * The grid is not stored, it is rebuilt from the cell positions, so only the chunks around cells are allocated.
+ */
+
+namespace
+{
+constexpr char SnapshotMagic[8] = {'C', 'E', 'L', 'L', 'S', 'N', 'A', 'P'};
+constexpr uint32_t SnapshotVersion = 2;
+constexpr uint32_t ByteOrderMark = 0x01020304u;
+
+struct SnapshotHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t ByteOrder;
+    int32_t Width;
+    int32_t Height;
+    uint32_t GenomeLength;
+    uint32_t OpcodeCount;
+    uint32_t Topology;
+    uint32_t Reserved;
+    uint64_t Seed;
+    uint64_t TickCount;
+    uint64_t RandomizeCount;
+    uint64_t SlotCount;
+    uint64_t CellCount;
+    uint64_t FreeCount;
+};
+
+template <typename T>
+void WriteValue(std::ofstream& Stream, const T& Value)
+{
+    Stream.write(reinterpret_cast<const char*>(&Value), sizeof(T));
+}
+
+template <typename T>
+void WriteArray(std::ofstream& Stream, const std::vector<T>& Values)
+{
+    Stream.write(reinterpret_cast<const char*>(Values.data()), static_cast<std::streamsize>(Values.size() * sizeof(T)));
+}
+
+/**
+ * Sequential bounds-checked reader over the mapped snapshot.
+ */
+class SnapshotReader
+{
+public:
+    SnapshotReader(const uint8_t* InData, size_t InSize) : Data(InData), Size(InSize) {}
+
+    template <typename T>
+    bool Read(T& OutValue)
+    {
+        return ReadArray(&OutValue, 1);
+    }
+
+    template <typename T>
+    bool ReadArray(T* OutValues, size_t Count)
+    {
+        const uint8_t* Source = TakeArray(Count, sizeof(T));
+        if (!Source) return false;
+        if (Count > 0) std::memcpy(OutValues, Source, Count * sizeof(T));
+        return true;
+    }
+
+    /**
+     * Returns a pointer to the next bytes and skips them, or nullptr if the file is too short.
+     * The pointer may be unaligned, so values have to be copied out with memcpy.
+     */
+    const uint8_t* Take(size_t Bytes)
+    {
+        if (Bytes > Size - Offset) return nullptr;
+        const uint8_t* Result = Data + Offset;
+        Offset += Bytes;
+        return Result;
+    }
+
+    /**
+     * Takes an array of Count elements of ElementSize bytes each, or returns nullptr if the file is too short.
+     * Counts come from the file, so they are checked against the remaining bytes before they are multiplied.
+     */
+    const uint8_t* TakeArray(size_t Count, size_t ElementSize)
+    {
+        if (ElementSize > 0 && Count > (Size - Offset) / ElementSize) return nullptr;
+        return Take(Count * ElementSize);
+    }
+
+private:
+    const uint8_t* Data;
+    size_t Size;
+    size_t Offset = 0;
+};
+
+template <typename T>
+T LoadAt(const uint8_t* Array, size_t Index)
+{
+    T Value;
+    std::memcpy(&Value, Array + Index * sizeof(T), sizeof(T));
+    return Value;
+}
+} // namespace
+
+bool Simulator::SaveSnapshot(const std::string& Path) const
+{
+    const size_t CellCount = ActiveIds.size();
+    const std::vector<CellId>& FreeSlots = Cells.GetFreeSlots();
+    const size_t CommandCount = CommandManager::GetRegisteredCommandCount();
+
+    SnapshotHeader Header{};
+    std::memcpy(Header.Magic, SnapshotMagic, sizeof(SnapshotMagic));
+    Header.Version = SnapshotVersion;
+    Header.ByteOrder = ByteOrderMark;
+    Header.Width = Width;
+    Header.Height = Height;
+    Header.GenomeLength = static_cast<uint32_t>(GenomeLength);
+    Header.OpcodeCount = static_cast<uint32_t>(CommandCount);
+    Header.Topology = static_cast<uint32_t>(Topology);
+    Header.Seed = Seed;
+    Header.TickCount = TickCount;
+    Header.RandomizeCount = RandomizeCount;
+    Header.SlotCount = Cells.GetSlotCount();
+    Header.CellCount = CellCount;
+    Header.FreeCount = FreeSlots.size();
+
+    // Gather the live cells into packed arrays in processing order.
+    std::vector<int32_t> X(CellCount);
+    std::vector<int32_t> Y(CellCount);
+    std::vector<EDirection> Direction(CellCount);
+    std::vector<float> Energy(CellCount);
+    std::vector<uint16_t> GenomePointer(CellCount);
+    std::vector<Opcode> Genomes(CellCount * GenomeLength);
+    for (size_t i = 0; i < CellCount; ++i)
+    {
+        const CellId Id = ActiveIds[i];
+        X[i] = Cells.GetX(Id);
+        Y[i] = Cells.GetY(Id);
+        Direction[i] = Cells.GetDirection(Id);
+        Energy[i] = Cells.GetEnergy(Id);
+        GenomePointer[i] = Cells.GetGenomePointer(Id);
+        const GenomeView Genome = Cells.GetGenome(Id);
+        std::memcpy(&Genomes[i * GenomeLength], Genome.data(), Genome.size() * sizeof(Opcode));
+    }
+
+    const std::string TempPath = Path + ".tmp";
+    {
+        std::ofstream Stream(TempPath, std::ios::binary | std::ios::trunc);
+        if (!Stream) return false;
+
+        WriteValue(Stream, Header);
+        for (size_t i = 0; i < CommandCount; ++i)
+        {
+            const std::string_view Name = CommandManager::GetCommandName(static_cast<Opcode>(i));
+            WriteValue(Stream, static_cast<uint16_t>(Name.size()));
+            Stream.write(Name.data(), static_cast<std::streamsize>(Name.size()));
+        }
+        WriteArray(Stream, FreeSlots);
+        WriteArray(Stream, ActiveIds);
+        WriteArray(Stream, X);
+        WriteArray(Stream, Y);
+        WriteArray(Stream, Direction);
+        WriteArray(Stream, Energy);
+        WriteArray(Stream, GenomePointer);
+        WriteArray(Stream, Genomes);
+
+        Stream.flush();
+        if (!Stream) return false;
+    }
+
+    std::error_code Error;
+    std::filesystem::rename(TempPath, Path, Error);
+    return !Error;
+}
+
+bool Simulator::LoadSnapshot(const std::string& Path)
+{
+    MappedFile File;
+    if (!File.Open(Path)) return false;
+    SnapshotReader Reader(File.GetData(), File.GetSize());
+
+    SnapshotHeader Header;
+    if (!Reader.Read(Header)) return false;
+    if (std::memcmp(Header.Magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0) return false;
+    if (Header.Version != SnapshotVersion || Header.ByteOrder != ByteOrderMark) return false;
+    if (Header.Width <= 0 || Header.Height <= 0 || Header.GenomeLength > std::numeric_limits<uint16_t>::max()) return false;
+    if (Header.OpcodeCount > CommandManager::MaxCommands) return false;
+    if (Header.Topology > static_cast<uint32_t>(EWorldTopology::Toroidal)) return false;
+    const EWorldTopology FileTopology = static_cast<EWorldTopology>(Header.Topology);
+    const bool bBounded = FileTopology != EWorldTopology::Unbounded;
+    const size_t TileCount = static_cast<size_t>(Header.Width) * static_cast<size_t>(Header.Height);
+    const size_t MaxSlotCount = bBounded ? TileCount : static_cast<size_t>(InvalidCellId);
+    // Each count is bounded before they are added, so a crafted header cannot wrap the sum around.
+    if (Header.SlotCount > MaxSlotCount || Header.CellCount > Header.SlotCount || Header.FreeCount > Header.SlotCount) return false;
+    if (Header.CellCount + Header.FreeCount != Header.SlotCount) return false;
+
+    // Map the opcodes of the file to the opcodes of this build by command name.
+    std::array<Opcode, CommandManager::MaxCommands> Remap{};
+    for (uint32_t i = 0; i < Header.OpcodeCount; ++i)
+    {
+        uint16_t NameLength;
+        if (!Reader.Read(NameLength)) return false;
+        const uint8_t* Name = Reader.Take(NameLength);
+        if (!Name) return false;
+        if (!CommandManager::FindOpcode({reinterpret_cast<const char*>(Name), NameLength}, Remap[i])) return false;
+    }
+
+    const size_t CellCount = Header.CellCount;
+    const uint8_t* FreeSlots = Reader.TakeArray(Header.FreeCount, sizeof(CellId));
+    const uint8_t* Ids = Reader.TakeArray(CellCount, sizeof(CellId));
+    const uint8_t* X = Reader.TakeArray(CellCount, sizeof(int32_t));
+    const uint8_t* Y = Reader.TakeArray(CellCount, sizeof(int32_t));
+    const uint8_t* Direction = Reader.TakeArray(CellCount, sizeof(EDirection));
+    const uint8_t* Energy = Reader.TakeArray(CellCount, sizeof(float));
+    const uint8_t* GenomePointer = Reader.TakeArray(CellCount, sizeof(uint16_t));
+    const uint8_t* Genomes = Reader.TakeArray(CellCount, Header.GenomeLength * sizeof(Opcode));
+    if (!FreeSlots || !Ids || !X || !Y || !Direction || !Energy || !GenomePointer || !Genomes) return false;
+    // The genomes fit into the file, so their size cannot overflow.
+    const size_t GenomeBytes = CellCount * Header.GenomeLength;
+
+    // Validate everything before touching the current state, so a bad file leaves the simulation intact.
+    std::vector<uint8_t> SlotUsed(Header.SlotCount, 0);
+    std::vector<uint64_t> Positions(CellCount);
+    for (size_t i = 0; i < Header.FreeCount; ++i)
+    {
+        const CellId Id = LoadAt<CellId>(FreeSlots, i);
+        if (Id >= Header.SlotCount || SlotUsed[Id]++) return false;
+    }
+    for (size_t i = 0; i < CellCount; ++i)
+    {
+        const CellId Id = LoadAt<CellId>(Ids, i);
+        if (Id >= Header.SlotCount || SlotUsed[Id]++) return false;
+        const int32_t CellX = LoadAt<int32_t>(X, i);
+        const int32_t CellY = LoadAt<int32_t>(Y, i);
+        if (bBounded && (CellX < 0 || CellX >= Header.Width || CellY < 0 || CellY >= Header.Height)) return false;
+        Positions[i] = GetPositionKey(CellX, CellY);
+        if (LoadAt<uint8_t>(Direction, i) > static_cast<uint8_t>(EDirection::None)) return false;
+        if (Header.GenomeLength > 0 && LoadAt<uint16_t>(GenomePointer, i) >= Header.GenomeLength) return false;
+    }
+    // The world may be unbounded, so duplicate positions are found by sorting instead of marking tiles.
+    std::sort(Positions.begin(), Positions.end());
+    if (std::adjacent_find(Positions.begin(), Positions.end()) != Positions.end()) return false;
+    for (size_t i = 0; i < GenomeBytes; ++i)
+    {
+        if (Genomes[i] >= Header.OpcodeCount) return false;
+    }
+
+    GenomeLength = static_cast<int32_t>(Header.GenomeLength);
+    Topology = FileTopology;
+    ResizeWorld(Header.Width, Header.Height);
+    Cells.Resize(Header.SlotCount, GenomeLength);
+    Seed = Header.Seed;
+    TickCount = Header.TickCount;
+    RandomizeCount = Header.RandomizeCount;
+
+    std::vector<CellId> FreeList(Header.FreeCount);
+    std::memcpy(FreeList.data(), FreeSlots, FreeList.size() * sizeof(CellId));
+    Cells.RestoreSlots(Header.SlotCount, FreeList.data(), FreeList.size());
+
+    ActiveIds.resize(CellCount);
+    std::memcpy(ActiveIds.data(), Ids, CellCount * sizeof(CellId));
+    std::vector<Opcode> Genome(GenomeLength);
+    for (size_t i = 0; i < CellCount; ++i)
+    {
+        const CellId Id = ActiveIds[i];
+        const uint8_t* Source = Genomes + i * GenomeLength;
+        for (int32_t Gene = 0; Gene < GenomeLength; ++Gene)
+        {
+            Genome[Gene] = Remap[Source[Gene]];
+        }
+        const int32_t CellX = LoadAt<int32_t>(X, i);
+        const int32_t CellY = LoadAt<int32_t>(Y, i);
+        Cells.Initialize(Id, CellX, CellY, static_cast<EDirection>(Direction[i]), {Genome.data(), Genome.size()}, LoadAt<float>(Energy, i));
+        Cells.SetGenomePointer(Id, LoadAt<uint16_t>(GenomePointer, i));
+        Grid[AcquireTile(CellX, CellY)].SetCellId(Id);
+    }
+    return true;
+}
@@ -0,0 +1,125 @@
+#include "CellularSimulator/Core/StatisticsRecorder.h"
+#include <charconv>
+#include <utility>
+
+using namespace CellularSimulator::Core;
+
+std::atomic<size_t> StatisticsRecorder::NextCounterSlot = 0;
+
+namespace
+{
+void AppendNumber(std::string& Row, uint64_t Value)
+{
+    char Digits[24];
+    const auto [End, Error] = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+    Row.append(Digits, End);
+}
+} // namespace
+
+StatisticsRecorder::~StatisticsRecorder()
+{
+    Close();
+}
+
+bool StatisticsRecorder::Open(const std::string& Path)
+{
+    Close();
+    Stream.open(Path, std::ios::trunc);
+    if (!Stream) return false;
+    for (ThreadCounters& Slot : Counters)
+    {
+        Slot.Moves.store(0, std::memory_order_relaxed);
+        Slot.Kills.store(0, std::memory_order_relaxed);
+    }
+    SubmittedCount = 0;
+    bStopping = false;
+
+    OpcodeCount = CommandManager::GetRegisteredCommandCount();
+    Stream << "tick,population,total_energy,births,deaths,moves,kills";
+    for (size_t i = 0; i < OpcodeCount; ++i)
+    {
+        Stream << "," << CommandManager::GetCommandName(static_cast<Opcode>(i));
+    }
+    Stream << "\n";
+    Writer = std::thread(&StatisticsRecorder::WriterLoop, this);
+    return static_cast<bool>(Stream);
+}
+
+bool StatisticsRecorder::Close()
+{
+    if (!Writer.joinable()) return true;
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        bStopping = true;
+    }
+    WorkAvailable.notify_one();
+    Writer.join();
+    const bool bWritten = static_cast<bool>(Stream.flush());
+    Stream.close();
+    return bWritten;
+}
+
+void StatisticsRecorder::TakeEvents(TickStatistics& OutStatistics)
+{
+    OutStatistics.Moves = 0;
+    OutStatistics.Kills = 0;
+    for (ThreadCounters& Slot : Counters)
+    {
+        OutStatistics.Moves += Slot.Moves.exchange(0, std::memory_order_relaxed);
+        OutStatistics.Kills += Slot.Kills.exchange(0, std::memory_order_relaxed);
+    }
+}
+
+void StatisticsRecorder::Submit(const TickStatistics& Statistics)
+{
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Pending.push_back(Statistics);
+    }
+    ++SubmittedCount;
+    WorkAvailable.notify_one();
+}
+
+void StatisticsRecorder::WriterLoop()
+{
+    std::vector<TickStatistics> Records;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> Lock(Mutex);
+            WorkAvailable.wait(Lock, [this] { return bStopping || !Pending.empty(); });
+            if (Pending.empty()) return;
+            // The queues are swapped, so the simulation only ever waits for a push_back.
+            Records.clear();
+            Records.swap(Pending);
+        }
+        WriteRecords(Records);
+    }
+}
+
+void StatisticsRecorder::WriteRecords(const std::vector<TickStatistics>& Records)
+{
+    Row.clear();
+    for (const TickStatistics& Record : Records)
+    {
+        AppendNumber(Row, Record.Tick);
+        Row += ',';
+        AppendNumber(Row, Record.Population);
+        Row += ',';
+        char Energy[32];
+        const auto [EnergyEnd, Error] = std::to_chars(Energy, Energy + sizeof(Energy), Record.TotalEnergy);
+        Row.append(Energy, EnergyEnd);
+        for (const uint64_t Value : {Record.Births, Record.Deaths, Record.Moves, Record.Kills})
+        {
+            Row += ',';
+            AppendNumber(Row, Value);
+        }
+        for (size_t i = 0; i < OpcodeCount; ++i)
+        {
+            Row += ',';
+            AppendNumber(Row, Record.OpcodeCounts[i]);
+        }
+        Row += '\n';
+    }
+    Stream.write(Row.data(), static_cast<std::streamsize>(Row.size()));
+}
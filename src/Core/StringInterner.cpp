@@ -1,19 +1,24 @@
 ﻿#include "CellularSimulator/Core/StringInterner.h"
 #include <functional>
 #include <map>
-#include "raylib.h"
 
 using namespace CellularSimulator::Core;
 
+StringInterner::StringInterner()
+{
+    // Commands capture their gene color when they register, which can happen during static initialization.
+    InitializeGeneColors();
+}
+
 void StringInterner::InitializeGeneColors()
 {
-    GeneColorMap[Intern("Photosynthesis")] = LIME;
-    GeneColorMap[Intern("MoveForward")] = BLUE;
-    GeneColorMap[Intern("EatForward")] = RED;
-    GeneColorMap[Intern("TurnRight")] = WHITE;
-    GeneColorMap[Intern("TurnLeft")] = WHITE;
-    GeneColorMap[Intern("Divide")] = GOLD;
-    GeneColorMap[Intern("Idle")] = GRAY;
+    GeneColorMap[Intern("Photosynthesis")] = {0, 158, 47, 255};
+    GeneColorMap[Intern("MoveForward")] = {0, 121, 241, 255};
+    GeneColorMap[Intern("EatForward")] = {230, 41, 55, 255};
+    GeneColorMap[Intern("TurnRight")] = {255, 255, 255, 255};
+    GeneColorMap[Intern("TurnLeft")] = {255, 255, 255, 255};
+    GeneColorMap[Intern("Divide")] = {255, 203, 0, 255};
+    GeneColorMap[Intern("Idle")] = {130, 130, 130, 255};
 }
 
 StringInterner& StringInterner::GetInstance()
@@ -47,17 +52,7 @@ std::string_view StringInterner::Resolve(size_t Hash) const
     return "UNKNOWN_HASH";
 }
 
-std::vector<std::string> StringInterner::ResolveGenome(const std::vector<size_t>& Genome) const
-{
-    std::vector<std::string> ResolvedGenome(Genome.size());
-    for (size_t i = 0; i < Genome.size(); ++i)
-    {
-        ResolvedGenome[i] = Resolve(Genome[i]);
-    }
-    return ResolvedGenome;
-}
-
-Color StringInterner::GetGeneColor(size_t Hash) const
+CellColor StringInterner::GetGeneColor(size_t Hash) const
 {
     if (GeneColorMap.find(Hash) != GeneColorMap.end()) return GeneColorMap.at(Hash);
     return DefaultColor;
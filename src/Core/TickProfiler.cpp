@@ -0,0 +1,151 @@
+#include "CellularSimulator/Core/TickProfiler.h"
+#include <fstream>
+#include <iomanip>
+
+using namespace CellularSimulator::Core;
+
+namespace
+{
+double ToMicroseconds(uint64_t Nanoseconds)
+{
+    return static_cast<double>(Nanoseconds) / 1000.0;
+}
+} // namespace
+
+TickProfiler::TickProfiler(size_t InCapacity) : Epoch(std::chrono::steady_clock::now()), Capacity(InCapacity)
+{
+}
+
+const char* TickProfiler::GetPhaseName(ETickPhase Phase)
+{
+    switch (Phase)
+    {
+        case ETickPhase::Decide: return "Decide";
+        case ETickPhase::Execute: return "Execute";
+        case ETickPhase::EnergyDrain: return "EnergyDrain";
+        case ETickPhase::RemoveDead: return "RemoveDead";
+        case ETickPhase::Compact: return "Compact";
+        default: return "Unknown";
+    }
+}
+
+void TickProfiler::SetCapacity(size_t InCapacity)
+{
+    Capacity = InCapacity;
+    Records.clear();
+    Records.shrink_to_fit();
+    Clear();
+}
+
+void TickProfiler::Clear()
+{
+    NextRecord = 0;
+    RecordCount = 0;
+}
+
+void TickProfiler::BeginTick(uint64_t Tick, uint64_t Cells)
+{
+    Current = TickProfile();
+    Current.Tick = Tick;
+    Current.Cells = Cells;
+    Current.StartNs = GetTimeNs();
+    PendingSpawns.store(0, std::memory_order_relaxed);
+    PendingDeaths.store(0, std::memory_order_relaxed);
+    PendingMoves.store(0, std::memory_order_relaxed);
+}
+
+void TickProfiler::EndTick()
+{
+    Current.DurationNs = GetTimeNs() - Current.StartNs;
+    Current.Spawns = PendingSpawns.load(std::memory_order_relaxed);
+    Current.Deaths = PendingDeaths.load(std::memory_order_relaxed);
+    Current.Moves = PendingMoves.load(std::memory_order_relaxed);
+    if (Capacity == 0) return;
+
+    // The ring is allocated on the first tick, so builds that never record pay nothing for it.
+    if (Records.size() != Capacity) Records.resize(Capacity);
+    Records[NextRecord] = Current;
+    NextRecord = (NextRecord + 1) % Capacity;
+    if (RecordCount < Capacity) ++RecordCount;
+}
+
+void TickProfiler::BeginPhase(ETickPhase Phase)
+{
+    Current.PhaseStartNs[static_cast<size_t>(Phase)] = GetTimeNs();
+}
+
+void TickProfiler::EndPhase(ETickPhase Phase)
+{
+    const size_t Index = static_cast<size_t>(Phase);
+    Current.PhaseDurationNs[Index] += GetTimeNs() - Current.PhaseStartNs[Index];
+}
+
+const TickProfile& TickProfiler::GetRecord(size_t Index) const
+{
+    const size_t Oldest = RecordCount < Capacity ? 0 : NextRecord;
+    return Records[(Oldest + Index) % Capacity];
+}
+
+bool TickProfiler::WriteChromeTrace(const std::string& Path) const
+{
+    std::ofstream Stream(Path, std::ios::trunc);
+    if (!Stream) return false;
+
+    Stream << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool bFirst = true;
+    auto BeginEvent = [&Stream, &bFirst]() -> std::ofstream& {
+        if (!bFirst) Stream << ",\n";
+        bFirst = false;
+        return Stream;
+    };
+
+    for (size_t i = 0; i < RecordCount; ++i)
+    {
+        const TickProfile& Record = GetRecord(i);
+        BeginEvent() << "{\"name\":\"Tick\",\"cat\":\"tick\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << ToMicroseconds(Record.StartNs)
+                     << ",\"dur\":" << ToMicroseconds(Record.DurationNs) << ",\"args\":{\"tick\":" << Record.Tick << ",\"cells\":" << Record.Cells
+                     << ",\"spawns\":" << Record.Spawns << ",\"deaths\":" << Record.Deaths << ",\"moves\":" << Record.Moves << "}}";
+        for (size_t Phase = 0; Phase < TickProfile::PhaseCount; ++Phase)
+        {
+            if (Record.PhaseStartNs[Phase] == 0) continue;
+            BeginEvent() << "{\"name\":\"" << GetPhaseName(static_cast<ETickPhase>(Phase)) << "\",\"cat\":\"phase\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":"
+                         << ToMicroseconds(Record.PhaseStartNs[Phase]) << ",\"dur\":" << ToMicroseconds(Record.PhaseDurationNs[Phase]) << "}";
+        }
+        BeginEvent() << "{\"name\":\"Population\",\"ph\":\"C\",\"pid\":1,\"ts\":" << ToMicroseconds(Record.StartNs) << ",\"args\":{\"cells\":" << Record.Cells
+                     << "}}";
+        BeginEvent() << "{\"name\":\"Events\",\"ph\":\"C\",\"pid\":1,\"ts\":" << ToMicroseconds(Record.StartNs) << ",\"args\":{\"spawns\":" << Record.Spawns
+                     << ",\"deaths\":" << Record.Deaths << ",\"moves\":" << Record.Moves << "}}";
+    }
+    Stream << "\n]}\n";
+    return static_cast<bool>(Stream);
+}
+
+bool TickProfiler::WriteCsv(const std::string& Path) const
+{
+    std::ofstream Stream(Path, std::ios::trunc);
+    if (!Stream) return false;
+
+    Stream << "tick,cells,spawns,deaths,moves,total_ns";
+    for (size_t Phase = 0; Phase < TickProfile::PhaseCount; ++Phase)
+    {
+        Stream << "," << GetPhaseName(static_cast<ETickPhase>(Phase)) << "_ns";
+    }
+    Stream << "\n";
+
+    for (size_t i = 0; i < RecordCount; ++i)
+    {
+        const TickProfile& Record = GetRecord(i);
+        Stream << Record.Tick << "," << Record.Cells << "," << Record.Spawns << "," << Record.Deaths << "," << Record.Moves << "," << Record.DurationNs;
+        for (const uint64_t Duration : Record.PhaseDurationNs)
+        {
+            Stream << "," << Duration;
+        }
+        Stream << "\n";
+    }
+    return static_cast<bool>(Stream);
+}
+
+uint64_t TickProfiler::GetTimeNs() const
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Epoch).count());
+}
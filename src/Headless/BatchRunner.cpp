@@ -0,0 +1,366 @@
+#include "CellularSimulator/Headless/BatchRunner.h"
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+
+using namespace CellularSimulator::Headless;
+
+namespace
+{
+template <typename TValue>
+bool ParseInteger(std::string_view Text, TValue& OutValue)
+{
+    const char* End = Text.data() + Text.size();
+    auto [Ptr, Error] = std::from_chars(Text.data(), End, OutValue);
+    return Error == std::errc() && Ptr == End;
+}
+
+bool ParseFloat(const std::string& Text, float& OutValue)
+{
+    char* End = nullptr;
+    OutValue = std::strtof(Text.c_str(), &End);
+    return !Text.empty() && End == Text.c_str() + Text.size();
+}
+/**
+ * Appends one row per genotype, with the genome written as two hex digits per gene.
+ */
+void WriteCensus(std::ostream& Stream, const CellularSimulator::Core::Simulator& Sim, size_t TopCount,
+    std::vector<CellularSimulator::Core::GenotypeCount>& Census)
+{
+    static constexpr char HexDigits[] = "0123456789abcdef";
+    Sim.GetGenotypeCensus(Census, TopCount);
+    std::string Genes;
+    for (size_t Rank = 0; Rank < Census.size(); ++Rank)
+    {
+        Genes.clear();
+        for (const CellularSimulator::Core::Opcode Gene : Sim.GetGenotypeGenes(Census[Rank].Genome))
+        {
+            Genes += HexDigits[Gene >> 4];
+            Genes += HexDigits[Gene & 15];
+        }
+        Stream << Sim.GetTickCount() << "," << Rank + 1 << "," << Census[Rank].Population << "," << Genes << "\n";
+    }
+}
+} // namespace
+
+BatchRunner::BatchRunner(const BatchConfig& InConfig) : Config(InConfig)
+{
+}
+
+std::optional<BatchConfig> BatchRunner::ParseCommandLine(int Argc, char** Argv, std::string& OutError)
+{
+    BatchConfig Result;
+    for (int i = 1; i < Argc; ++i)
+    {
+        const std::string Option = Argv[i];
+        if (Option == "--help" || Option == "-h")
+        {
+            OutError.clear();
+            return std::nullopt;
+        }
+        if (i + 1 >= Argc)
+        {
+            OutError = "Missing value for option '" + Option + "'";
+            return std::nullopt;
+        }
+        const std::string Value = Argv[++i];
+
+        bool bParsed = false;
+        if (Option == "--width")
+        {
+            bParsed = ParseInteger(Value, Result.Width) && Result.Width > 0;
+        }
+        else if (Option == "--height")
+        {
+            bParsed = ParseInteger(Value, Result.Height) && Result.Height > 0;
+        }
+        else if (Option == "--density")
+        {
+            bParsed = ParseFloat(Value, Result.Density) && Result.Density >= 0.0f && Result.Density <= 1.0f;
+        }
+        else if (Option == "--seed")
+        {
+            bParsed = ParseInteger(Value, Result.Seed);
+        }
+        else if (Option == "--ticks")
+        {
+            bParsed = ParseInteger(Value, Result.Ticks);
+        }
+        else if (Option == "--topology")
+        {
+            bParsed = Value == "bounded" || Value == "unbounded" || Value == "torus";
+            Result.Topology = Core::EWorldTopology::Bounded;
+            if (Value == "unbounded") Result.Topology = Core::EWorldTopology::Unbounded;
+            if (Value == "torus") Result.Topology = Core::EWorldTopology::Toroidal;
+        }
+        else if (Option == "--colony-size")
+        {
+            bParsed = ParseInteger(Value, Result.ColonySize) && Result.ColonySize >= 0;
+        }
+        else if (Option == "--compact-every")
+        {
+            bParsed = ParseInteger(Value, Result.CompactionInterval);
+        }
+        else if (Option == "--compact-threshold")
+        {
+            bParsed = ParseFloat(Value, Result.CompactionThreshold) && Result.CompactionThreshold >= 0.0f && Result.CompactionThreshold <= 1.0f;
+        }
+        else if (Option == "--load")
+        {
+            Result.LoadPath = Value;
+            bParsed = !Value.empty();
+        }
+        else if (Option == "--save")
+        {
+            Result.SavePath = Value;
+            bParsed = !Value.empty();
+        }
+        else if (Option == "--trace")
+        {
+            Result.TracePath = Value;
+            bParsed = !Value.empty();
+        }
+        else if (Option == "--profile-csv")
+        {
+            Result.ProfileCsvPath = Value;
+            bParsed = !Value.empty();
+        }
+        else if (Option == "--census-csv")
+        {
+            Result.CensusCsvPath = Value;
+            bParsed = !Value.empty();
+        }
+        else if (Option == "--census-every")
+        {
+            bParsed = ParseInteger(Value, Result.CensusInterval);
+        }
+        else if (Option == "--census-top")
+        {
+            bParsed = ParseInteger(Value, Result.CensusTopCount);
+        }
+        else if (Option == "--stats-csv")
+        {
+            Result.StatisticsCsvPath = Value;
+            bParsed = !Value.empty();
+        }
+        else if (Option == "--lineage")
+        {
+            Result.LineagePath = Value;
+            bParsed = !Value.empty();
+        }
+        else if (Option == "--lineage-retain")
+        {
+            bParsed = ParseInteger(Value, Result.LineageRetainedAncestors);
+        }
+        else if (Option == "--checkpoint-every")
+        {
+            bParsed = ParseInteger(Value, Result.CheckpointInterval);
+        }
+        else if (Option == "--mode")
+        {
+            bParsed = Value == "serial" || Value == "parallel";
+            Result.ExecutionMode = Value == "parallel" ? Core::EExecutionMode::Parallel : Core::EExecutionMode::Serial;
+        }
+        else
+        {
+            OutError = "Unknown option '" + Option + "'";
+            return std::nullopt;
+        }
+
+        if (!bParsed)
+        {
+            OutError = "Invalid value '" + Value + "' for option '" + Option + "'";
+            return std::nullopt;
+        }
+    }
+    if (Result.CheckpointInterval > 0 && Result.SavePath.empty())
+    {
+        OutError = "Option '--checkpoint-every' requires '--save'";
+        return std::nullopt;
+    }
+    if (Result.CensusInterval > 0 && Result.CensusCsvPath.empty())
+    {
+        OutError = "Option '--census-every' requires '--census-csv'";
+        return std::nullopt;
+    }
+    return Result;
+}
+
+std::string BatchRunner::GetUsage(const std::string& ProgramName)
+{
+    std::ostringstream Usage;
+    Usage << "Usage: " << ProgramName << " [options]\n"
+          << "  --width <int>           Grid width (default 300)\n"
+          << "  --height <int>          Grid height (default 300)\n"
+          << "  --density <float>       Initial cell density in [0, 1] (default 0.5)\n"
+          << "  --seed <uint>           Random seed (default 5489)\n"
+          << "  --ticks <uint>          Number of simulation steps (default 1000)\n"
+          << "  --mode <name>           Command execution mode: serial or parallel (default serial)\n"
+          << "  --topology <name>       World topology: bounded, unbounded or torus (default bounded)\n"
+          << "  --colony-size <int>     Randomize only a square of this size in the middle of the grid (default 0, whole grid)\n"
+          << "  --compact-every <uint>  Ticks between spatial compactions of the cell store (default 0, off)\n"
+          << "  --compact-threshold <float>\n"
+          << "                          Share of cells out of store order that triggers a compaction (default 0.25, 0 is off)\n"
+          << "  --load <path>           Start from a snapshot instead of a randomized world\n"
+          << "  --save <path>           Write a snapshot at the end of the run\n"
+          << "  --checkpoint-every <uint>\n"
+          << "                          Ticks between snapshots written to the --save path (default 0, end only)\n"
+          << "  --trace <path>          Write the per-phase tick profile as a Chrome trace (profiling builds)\n"
+          << "  --profile-csv <path>    Write the per-phase tick profile as CSV (profiling builds)\n"
+          << "  --census-csv <path>     Write the genotype census (tick, rank, population, genes in hex) as CSV\n"
+          << "  --census-every <uint>   Ticks between genotype censuses written to --census-csv (default 0, end only)\n"
+          << "  --census-top <uint>     Number of most common genotypes per census (default 0, all)\n"
+          << "  --stats-csv <path>      Stream population, energy, births, deaths, moves, kills and gene counts of every tick as CSV\n"
+          << "  --lineage <path>        Record which genotype descended from which to a binary lineage file\n"
+          << "  --lineage-retain <uint> Extinct ancestors kept in memory so dead branches are pruned (default 65536)\n"
+          << "  --help                  Show this message\n";
+    return Usage.str();
+}
+
+int BatchRunner::Run()
+{
+    Core::Simulator Sim(Config.Width, Config.Height, Config.Topology);
+    Sim.SetSeed(Config.Seed);
+    Sim.SetExecutionMode(Config.ExecutionMode);
+    Sim.SetCompactionInterval(Config.CompactionInterval);
+    Sim.SetCompactionThreshold(Config.CompactionThreshold);
+    if (Config.LoadPath.empty())
+    {
+        if (Config.ColonySize > 0)
+        {
+            Sim.Clear();
+            Sim.PopulateRegion((Config.Width - Config.ColonySize) / 2, (Config.Height - Config.ColonySize) / 2, Config.ColonySize, Config.ColonySize,
+                Config.Density);
+        }
+        else
+        {
+            Sim.Randomize(Config.Density);
+        }
+        const char* TopologyName = "";
+        if (Config.Topology == Core::EWorldTopology::Unbounded) TopologyName = " unbounded";
+        if (Config.Topology == Core::EWorldTopology::Toroidal) TopologyName = " torus";
+        std::cout << "Grid " << Config.Width << "x" << Config.Height << TopologyName << ", density " << Config.Density << ", seed " << Config.Seed;
+    }
+    else
+    {
+        if (!Sim.LoadSnapshot(Config.LoadPath))
+        {
+            std::cerr << "Failed to load snapshot '" << Config.LoadPath << "'\n";
+            return 1;
+        }
+        std::cout << "Snapshot '" << Config.LoadPath << "', grid " << Sim.GetWidth() << "x" << Sim.GetHeight() << ", seed " << Sim.GetSeed()
+                  << ", tick " << Sim.GetTickCount();
+    }
+    std::cout << ", " << (Config.ExecutionMode == Core::EExecutionMode::Parallel ? "parallel" : "serial") << " mode"
+              << ", initial population " << Sim.GetActiveCellCount() << "\n";
+
+    const bool bWantsProfile = !Config.TracePath.empty() || !Config.ProfileCsvPath.empty();
+    if (bWantsProfile && !Core::TickProfiler::IsEnabled())
+    {
+        std::cerr << "Tick profiling is not compiled in, reconfigure with -DCELLULAR_SIMULATOR_ENABLE_PROFILING=ON\n";
+    }
+    if (bWantsProfile)
+    {
+        Sim.GetProfiler().SetCapacity(static_cast<size_t>(Config.Ticks));
+    }
+
+    std::ofstream CensusStream;
+    std::vector<Core::GenotypeCount> Census;
+    if (!Config.CensusCsvPath.empty())
+    {
+        CensusStream.open(Config.CensusCsvPath, std::ios::trunc);
+        if (!CensusStream)
+        {
+            std::cerr << "Failed to open census '" << Config.CensusCsvPath << "'\n";
+            return 1;
+        }
+        CensusStream << "tick,rank,population,genome\n";
+    }
+
+    if (!Config.LineagePath.empty() && !Sim.StartLineageRecording(Config.LineagePath, Config.LineageRetainedAncestors))
+    {
+        std::cerr << "Failed to open lineage '" << Config.LineagePath << "'\n";
+        return 1;
+    }
+
+    if (!Config.StatisticsCsvPath.empty() && !Sim.StartStatisticsRecording(Config.StatisticsCsvPath))
+    {
+        std::cerr << "Failed to open statistics '" << Config.StatisticsCsvPath << "'\n";
+        return 1;
+    }
+
+    uint64_t ProcessedCells = 0;
+    const auto StartTime = std::chrono::steady_clock::now();
+    for (uint64_t Tick = 0; Tick < Config.Ticks; ++Tick)
+    {
+        ProcessedCells += Sim.GetActiveCellCount();
+        Sim.Update();
+        if (Config.CheckpointInterval > 0 && (Tick + 1) % Config.CheckpointInterval == 0 && !Sim.SaveSnapshot(Config.SavePath))
+        {
+            std::cerr << "Failed to write checkpoint '" << Config.SavePath << "'\n";
+        }
+        if (Config.CensusInterval > 0 && (Tick + 1) % Config.CensusInterval == 0)
+        {
+            WriteCensus(CensusStream, Sim, Config.CensusTopCount, Census);
+        }
+    }
+    const auto EndTime = std::chrono::steady_clock::now();
+
+    if (!Config.SavePath.empty() && !Sim.SaveSnapshot(Config.SavePath))
+    {
+        std::cerr << "Failed to save snapshot '" << Config.SavePath << "'\n";
+        return 1;
+    }
+
+    if (CensusStream.is_open())
+    {
+        // The last census is skipped if the periodic one already covered the final tick.
+        if (Config.CensusInterval == 0 || Config.Ticks % Config.CensusInterval != 0) WriteCensus(CensusStream, Sim, Config.CensusTopCount, Census);
+        if (!CensusStream.flush())
+        {
+            std::cerr << "Failed to write census '" << Config.CensusCsvPath << "'\n";
+        }
+    }
+
+    if (!Sim.StopStatisticsRecording())
+    {
+        std::cerr << "Failed to write statistics '" << Config.StatisticsCsvPath << "'\n";
+    }
+
+    if (const Core::LineageRecorder* Lineage = Sim.GetLineageRecorder())
+    {
+        const uint64_t Retained = Lineage->GetRetainedCount();
+        const uint64_t Written = Lineage->GetWrittenCount() + Retained;
+        if (!Sim.StopLineageRecording())
+        {
+            std::cerr << "Failed to write lineage '" << Config.LineagePath << "'\n";
+        }
+        std::cout << "Lineage: " << Written << " genotypes recorded\n";
+    }
+
+    if (!Config.TracePath.empty() && !Sim.GetProfiler().WriteChromeTrace(Config.TracePath))
+    {
+        std::cerr << "Failed to write trace '" << Config.TracePath << "'\n";
+    }
+    if (!Config.ProfileCsvPath.empty() && !Sim.GetProfiler().WriteCsv(Config.ProfileCsvPath))
+    {
+        std::cerr << "Failed to write profile '" << Config.ProfileCsvPath << "'\n";
+    }
+
+    const double Seconds = std::chrono::duration<double>(EndTime - StartTime).count();
+    const double TicksPerSecond = Seconds > 0.0 ? static_cast<double>(Config.Ticks) / Seconds : 0.0;
+    const double NsPerCell = ProcessedCells > 0 ? Seconds * 1e9 / static_cast<double>(ProcessedCells) : 0.0;
+
+    std::cout << std::fixed << std::setprecision(3) << "Ran " << Config.Ticks << " ticks in " << Seconds << " s\n"
+              << "Final population: " << Sim.GetActiveCellCount() << "\n"
+              << "Genotypes: " << Sim.GetGenotypeCount() << "\n"
+              << "Allocated chunks: " << Sim.GetAllocatedChunkCount() << "\n"
+              << "Ticks/second: " << TicksPerSecond << "\n"
+              << "ns/cell/tick: " << NsPerCell << "\n";
+    return 0;
+}
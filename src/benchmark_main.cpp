@@ -0,0 +1,22 @@
+#include <iostream>
+#include "CellularSimulator/Benchmark/BenchmarkSuite.h"
+
+int main(int argc, char** argv)
+{
+    using CellularSimulator::Benchmark::BenchmarkSuite;
+
+    std::string Error;
+    const auto Config = BenchmarkSuite::ParseCommandLine(argc, argv, Error);
+    if (!Config)
+    {
+        if (!Error.empty())
+        {
+            std::cerr << Error << "\n";
+        }
+        std::cerr << BenchmarkSuite::GetUsage(argv[0]);
+        return Error.empty() ? 0 : 1;
+    }
+
+    BenchmarkSuite Suite(*Config);
+    return Suite.Run();
+}
@@ -0,0 +1,22 @@
+#include <iostream>
+#include "CellularSimulator/Headless/BatchRunner.h"
+
+int main(int argc, char** argv)
+{
+    using CellularSimulator::Headless::BatchRunner;
+
+    std::string Error;
+    const auto Config = BatchRunner::ParseCommandLine(argc, argv, Error);
+    if (!Config)
+    {
+        if (!Error.empty())
+        {
+            std::cerr << Error << "\n";
+        }
+        std::cerr << BatchRunner::GetUsage(argv[0]);
+        return Error.empty() ? 0 : 1;
+    }
+
+    BatchRunner Runner(*Config);
+    return Runner.Run();
+}
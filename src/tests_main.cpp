@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "CellularSimulator/Core/Simulator.h"
+
+using CellularSimulator::Core::Simulator;
+
+namespace
+{
+// Offsets of the header fields the tests tamper with, see the layout in SimulatorSnapshot.cpp.
+constexpr size_t SlotCountOffset = 64;
+constexpr size_t CellCountOffset = 72;
+constexpr size_t FreeCountOffset = 80;
+constexpr size_t HeaderSize = 88;
+
+int FailureCount = 0;
+
+void Check(bool bCondition, const char* Description)
+{
+    if (bCondition) return;
+    std::cerr << "FAILED: " << Description << "\n";
+    ++FailureCount;
+}
+
+std::vector<char> ReadFile(const std::string& Path)
+{
+    std::ifstream Stream(Path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(Stream), std::istreambuf_iterator<char>()};
+}
+
+void WriteFile(const std::string& Path, const std::vector<char>& Bytes)
+{
+    std::ofstream Stream(Path, std::ios::binary | std::ios::trunc);
+    Stream.write(Bytes.data(), static_cast<std::streamsize>(Bytes.size()));
+}
+
+uint64_t GetField(const std::vector<char>& Bytes, size_t Offset)
+{
+    uint64_t Value;
+    std::memcpy(&Value, Bytes.data() + Offset, sizeof(Value));
+    return Value;
+}
+
+void SetField(std::vector<char>& Bytes, size_t Offset, uint64_t Value)
+{
+    std::memcpy(Bytes.data() + Offset, &Value, sizeof(Value));
+}
+
+/**
+ * Loads a damaged copy of a valid snapshot and checks that it is rejected without touching the simulation.
+ */
+void ExpectRejected(const std::string& Path, const std::vector<char>& Bytes, const char* Description)
+{
+    WriteFile(Path, Bytes);
+    Simulator Sim(16, 16);
+    Sim.Randomize(0.5f);
+    Sim.Update();
+    const size_t CellCount = Sim.GetActiveCellCount();
+    Check(!Sim.LoadSnapshot(Path), Description);
+    Check(Sim.GetActiveCellCount() == CellCount && Sim.GetTickCount() == 1, Description);
+}
+
+void TestSnapshotValidation(const std::filesystem::path& Directory)
+{
+    const std::string ValidPath = (Directory / "valid.snap").string();
+    const std::string DamagedPath = (Directory / "damaged.snap").string();
+    {
+        Simulator Sim(64, 48);
+        Sim.Randomize(0.4f);
+        for (int Tick = 0; Tick < 20; ++Tick)
+        {
+            Sim.Update();
+        }
+        Check(Sim.SaveSnapshot(ValidPath), "a snapshot is saved");
+        Simulator Loaded(8, 8);
+        Check(Loaded.LoadSnapshot(ValidPath), "a valid snapshot loads");
+        Check(Loaded.GetActiveCellCount() == Sim.GetActiveCellCount(), "a valid snapshot restores every cell");
+    }
+    const std::vector<char> Valid = ReadFile(ValidPath);
+    Check(Valid.size() > HeaderSize, "the snapshot holds more than its header");
+    const uint64_t SlotCount = GetField(Valid, SlotCountOffset);
+
+    ExpectRejected(DamagedPath, {Valid.begin(), Valid.begin() + HeaderSize / 2}, "a truncated header is rejected");
+    ExpectRejected(DamagedPath, {Valid.begin(), Valid.end() - 1}, "a truncated genome array is rejected");
+
+    std::vector<char> Damaged = Valid;
+    SetField(Damaged, CellCountOffset, GetField(Valid, CellCountOffset) + 1);
+    ExpectRejected(DamagedPath, Damaged, "cell and free counts that do not add up are rejected");
+
+    // The counts add up to the slot count modulo 2^64, and the free list shrinks to a few bytes when multiplied.
+    Damaged = Valid;
+    SetField(Damaged, CellCountOffset, uint64_t{1} << 63);
+    SetField(Damaged, FreeCountOffset, SlotCount + (uint64_t{1} << 63));
+    ExpectRejected(DamagedPath, Damaged, "counts whose sum wraps around are rejected");
+
+    Damaged = Valid;
+    SetField(Damaged, SlotCountOffset, ~uint64_t{0});
+    ExpectRejected(DamagedPath, Damaged, "a slot count beyond the world is rejected");
+}
+} // namespace
+
+int main()
+{
+    const std::filesystem::path Directory = std::filesystem::temp_directory_path() / "CellularSimulatorTests";
+    std::filesystem::create_directories(Directory);
+    TestSnapshotValidation(Directory);
+    std::filesystem::remove_all(Directory);
+
+    if (FailureCount > 0)
+    {
+        std::cerr << FailureCount << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}